@@ -365,6 +365,12 @@ void HDF5OutputAdaptor::write(const std::string & tag, const Dimens dimens, cons
   write(tag, dimens, (const long *) i_array);
 }
 
+void HDF5OutputAdaptor::write(const std::string & tag, const Dimens dimens, const_strided_view<longid> i_view)
+{
+  assert_eq(sizeof(long),sizeof(longid));
+  write_strided(tag, dimens, H5T_NATIVE_LONG, i_view.get_base(), i_view.get_stride());
+}
+
 void HDF5OutputAdaptor::write(const std::string & tag, const Dimens dimens, const std::vector < int >&i_array) {
   //try {
     int n = dimens.nels();
@@ -628,6 +634,66 @@ void HDF5OutputAdaptor::write(const std::string & tag, const Dimens dimens, cons
   //}
 }
 
+void HDF5OutputAdaptor::write(const std::string & tag, const Dimens dimens, const_strided_view<double> d_view)
+{
+  write_strided(tag, dimens, H5T_NATIVE_DOUBLE, d_view.get_base(), d_view.get_stride());
+}
+
+// write every stride-th element of a one-dimensional array
+// (e.g. one component of an array of particles)
+// by means of a hyperslab selection, so that the data
+// need not first be copied into a contiguous buffer.
+//
+void HDF5OutputAdaptor::write_strided(const std::string & tag, const Dimens dimens,
+  hid_t type_id, const void *base, int stride)
+{
+  if (dimens.size() != 1) {
+    eprintf("Dimens size not 1 for object %s", tag.c_str());
+  }
+
+  std::vector < hid_t > hid_array;
+  std::string dataset_name;
+
+  get_dataset_context(tag, hid_array, dataset_name);
+  const hid_t group_id = hid_array[hid_array.size() - 1];
+
+  hsize_t nels = dimens[0];
+
+  hid_t dataset_id;
+  herr_t hdf5err = H5LTfind_dataset(group_id, dataset_name.c_str());
+  if (hdf5err < 1) {
+    hid_t filespace_id = H5Screate_simple(1, &nels, NULL);
+    dataset_id = H5Dcreate2(group_id, dataset_name.c_str(), type_id,
+      filespace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Sclose(filespace_id);
+  }
+  else {
+    dataset_id = H5Dopen2(group_id, dataset_name.c_str(), H5P_DEFAULT); // HDF 1.8
+  }
+  hdf5err = dataset_id < 0 ? -1 : 0;
+
+  if (nels > 0 && hdf5err >= 0) {
+    // select every stride-th element of the memory buffer
+    hsize_t memsize = (nels - 1) * stride + 1;
+    hsize_t start = 0;
+    hsize_t mem_stride = stride;
+    hid_t memspace_id = H5Screate_simple(1, &memsize, NULL);
+    H5Sselect_hyperslab(memspace_id, H5S_SELECT_SET, &start, &mem_stride, &nels, NULL);
+    hdf5err = H5Dwrite(dataset_id, type_id, memspace_id, H5S_ALL, H5P_DEFAULT, base);
+    H5Sclose(memspace_id);
+  }
+  if (dataset_id >= 0)
+    H5Dclose(dataset_id);
+
+  if (hdf5err < 0) {
+    eprintf("make_dataset fails for %s", tag.c_str());
+  }
+
+  // close groups, if any, but don't try to close the file id at [0]
+  for (int i = hid_array.size() - 1; i > 0; --i)
+    hdf5err = H5Gclose(hid_array[i]);
+}
+
 void HDF5OutputAdaptor::write(const std::string & tag, const Dimens dimens, const std::vector < double >&d_array) {
   //try {
     int n = dimens.nels();
@@ -84,6 +84,49 @@ void communicateGhostFace(int b_len, int myrank, int right_neighbor, int left_ne
 
   delete[]LEN;
 }
+/** nonblocking communicateGhostFace(): post the exchange of the
+    two faces, whose contents arrive in recvRightFace and recvLeftFace.
+    ghostRightFace and ghostLeftFace must not be modified until
+    finishGhostFace() is called with the same arguments. **/
+void startGhostFace(int b_len, int right_neighbor, int left_neighbor, int DIR, int XLEN, int YLEN, int ZLEN, double *ghostRightFace, double *ghostLeftFace, double *recvRightFace, double *recvLeftFace, MPI_Request *requests) {
+  // the two directions use different tags, since the
+  // right and left neighbors can be the same process
+  const int rightward_tag = 2;
+  const int leftward_tag = 3;
+  const int LEN[3] = {XLEN, YLEN, ZLEN};
+  for (int i = 0; i < 4; i++)
+    requests[i] = MPI_REQUEST_NULL;
+  // with a single process in this direction the faces are just swapped
+  if (LEN[DIR] == 1)
+    return;
+  if (right_neighbor != MPI_PROC_NULL) {
+    MPI_Irecv(recvRightFace, b_len, MPI_DOUBLE, right_neighbor, leftward_tag, MPI_COMM_WORLD, &requests[0]);
+    MPI_Isend(ghostRightFace, b_len, MPI_DOUBLE, right_neighbor, rightward_tag, MPI_COMM_WORLD, &requests[1]);
+  }
+  if (left_neighbor != MPI_PROC_NULL) {
+    MPI_Irecv(recvLeftFace, b_len, MPI_DOUBLE, left_neighbor, rightward_tag, MPI_COMM_WORLD, &requests[2]);
+    MPI_Isend(ghostLeftFace, b_len, MPI_DOUBLE, left_neighbor, leftward_tag, MPI_COMM_WORLD, &requests[3]);
+  }
+}
+
+/** complete the exchange posted by startGhostFace(): on return the
+    faces hold what communicateGhostFace() would have put in them **/
+void finishGhostFace(int b_len, int right_neighbor, int left_neighbor, int DIR, int XLEN, int YLEN, int ZLEN, double *ghostRightFace, double *ghostLeftFace, double *recvRightFace, double *recvLeftFace, MPI_Request *requests) {
+  const int LEN[3] = {XLEN, YLEN, ZLEN};
+  if (LEN[DIR] == 1) {
+    if (right_neighbor != MPI_PROC_NULL && left_neighbor != MPI_PROC_NULL)
+      swapBuffer(b_len, ghostLeftFace, ghostRightFace);
+    return;
+  }
+  MPI_Waitall(4, requests, MPI_STATUSES_IGNORE);
+  if (right_neighbor != MPI_PROC_NULL)
+    for (int i = 0; i < b_len; i++)
+      ghostRightFace[i] = recvRightFace[i];
+  if (left_neighbor != MPI_PROC_NULL)
+    for (int i = 0; i < b_len; i++)
+      ghostLeftFace[i] = recvLeftFace[i];
+}
+
 /** communicate ghost edge along a direction; there are 6 Diagonal directions through which we exchange Ghost Edges :
   0 = from   XrightYrightZsame to YleftZleftZsame; we exchange Z edge
   1 = from   XrightYleftZsame to XleftYrightZsame; we exchange Z edge
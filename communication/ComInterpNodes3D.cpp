@@ -99,3 +99,136 @@ void communicateInterp(int nx, int ny, int nz, int ns, double**** vector, int bc
   delete[]ghostXleftYleftZsameEdge;
   delete[]ghostXleftYrightZsameEdge;
 }
+
+BatchedInterpExchange::BatchedInterpExchange(int nx_, int ny_, int nz_, int ncomp_, double ***const *vectors_, VirtualTopology3D * vct_):
+  nx(nx_), ny(ny_), nz(nz_), ncomp(ncomp_), vectors(vectors_), vct(vct_)
+{
+  // allocate 6 ghost cell Faces and the buffers to receive them
+  ghostXrightFace = new double[(ny - 2) * (nz - 2) * ncomp];
+  ghostXleftFace = new double[(ny - 2) * (nz - 2) * ncomp];
+  ghostYrightFace = new double[(nx - 2) * (nz - 2) * ncomp];
+  ghostYleftFace = new double[(nx - 2) * (nz - 2) * ncomp];
+  ghostZrightFace = new double[(nx - 2) * (ny - 2) * ncomp];
+  ghostZleftFace = new double[(nx - 2) * (ny - 2) * ncomp];
+  recvXrightFace = new double[(ny - 2) * (nz - 2) * ncomp];
+  recvXleftFace = new double[(ny - 2) * (nz - 2) * ncomp];
+  recvYrightFace = new double[(nx - 2) * (nz - 2) * ncomp];
+  recvYleftFace = new double[(nx - 2) * (nz - 2) * ncomp];
+  recvZrightFace = new double[(nx - 2) * (ny - 2) * ncomp];
+  recvZleftFace = new double[(nx - 2) * (ny - 2) * ncomp];
+}
+
+BatchedInterpExchange::~BatchedInterpExchange()
+{
+  delete[]ghostXrightFace;
+  delete[]ghostXleftFace;
+  delete[]ghostYrightFace;
+  delete[]ghostYleftFace;
+  delete[]ghostZrightFace;
+  delete[]ghostZleftFace;
+  delete[]recvXrightFace;
+  delete[]recvXleftFace;
+  delete[]recvYrightFace;
+  delete[]recvYleftFace;
+  delete[]recvZrightFace;
+  delete[]recvZleftFace;
+}
+
+/** post the exchange of the 6 ghost faces along the 3 directions */
+void BatchedInterpExchange::begin() {
+  makeFace_batched(nx, ny, nz, vectors, ncomp, 1, ghostXrightFace, ghostXleftFace, ghostYrightFace, ghostYleftFace, ghostZrightFace, ghostZleftFace);
+  startGhostFace((ny - 2) * (nz - 2) * ncomp, vct->getXright_neighbor_P(), vct->getXleft_neighbor_P(), 0, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightFace, ghostXleftFace, recvXrightFace, recvXleftFace, requests[0]);
+  startGhostFace((nx - 2) * (nz - 2) * ncomp, vct->getYright_neighbor_P(), vct->getYleft_neighbor_P(), 1, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostYrightFace, ghostYleftFace, recvYrightFace, recvYleftFace, requests[1]);
+  startGhostFace((nx - 2) * (ny - 2) * ncomp, vct->getZright_neighbor_P(), vct->getZleft_neighbor_P(), 2, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostZrightFace, ghostZleftFace, recvZrightFace, recvZleftFace, requests[2]);
+}
+
+/** complete the exchange of faces and sum them, then exchange and sum edges and corners */
+void BatchedInterpExchange::end() {
+  finishGhostFace((ny - 2) * (nz - 2) * ncomp, vct->getXright_neighbor_P(), vct->getXleft_neighbor_P(), 0, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightFace, ghostXleftFace, recvXrightFace, recvXleftFace, requests[0]);
+  finishGhostFace((nx - 2) * (nz - 2) * ncomp, vct->getYright_neighbor_P(), vct->getYleft_neighbor_P(), 1, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostYrightFace, ghostYleftFace, recvYrightFace, recvYleftFace, requests[1]);
+  finishGhostFace((nx - 2) * (ny - 2) * ncomp, vct->getZright_neighbor_P(), vct->getZleft_neighbor_P(), 2, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostZrightFace, ghostZleftFace, recvZrightFace, recvZleftFace, requests[2]);
+  addFace_batched(nx, ny, nz, vectors, ncomp, ghostXrightFace, ghostXleftFace, ghostYrightFace, ghostYleftFace, ghostZrightFace, ghostZleftFace, vct);
+
+  // allocate 12 ghost cell Edges
+  // X EDGE
+  double *ghostXsameYleftZleftEdge = new double[(nx - 2) * ncomp];
+  double *ghostXsameYrightZleftEdge = new double[(nx - 2) * ncomp];
+  double *ghostXsameYleftZrightEdge = new double[(nx - 2) * ncomp];
+  double *ghostXsameYrightZrightEdge = new double[(nx - 2) * ncomp];
+  // Y EDGE
+  double *ghostXrightYsameZleftEdge = new double[(ny - 2) * ncomp];
+  double *ghostXleftYsameZleftEdge = new double[(ny - 2) * ncomp];
+  double *ghostXrightYsameZrightEdge = new double[(ny - 2) * ncomp];
+  double *ghostXleftYsameZrightEdge = new double[(ny - 2) * ncomp];
+  // Z EDGE
+  double *ghostXrightYleftZsameEdge = new double[(nz - 2) * ncomp];
+  double *ghostXrightYrightZsameEdge = new double[(nz - 2) * ncomp];
+  double *ghostXleftYleftZsameEdge = new double[(nz - 2) * ncomp];
+  double *ghostXleftYrightZsameEdge = new double[(nz - 2) * ncomp];
+  // allocate 8 ghost cell corner
+  double *ghostXrightYrightZrightCorner = new double[ncomp];
+  double *ghostXleftYrightZrightCorner = new double[ncomp];
+  double *ghostXrightYleftZrightCorner = new double[ncomp];
+  double *ghostXleftYleftZrightCorner = new double[ncomp];
+  double *ghostXrightYrightZleftCorner = new double[ncomp];
+  double *ghostXleftYrightZleftCorner = new double[ncomp];
+  double *ghostXrightYleftZleftCorner = new double[ncomp];
+  double *ghostXleftYleftZleftCorner = new double[ncomp];
+
+  makeNodeEdgeY_batched(nx, ny, nz, ncomp, ghostZleftFace, ghostZrightFace, ghostXrightYsameZrightEdge, ghostXleftYsameZleftEdge, ghostXleftYsameZrightEdge, ghostXrightYsameZleftEdge);
+  makeNodeEdgeZ_batched(nx, ny, nz, ncomp, ghostXleftFace, ghostXrightFace, ghostXrightYrightZsameEdge, ghostXleftYleftZsameEdge, ghostXrightYleftZsameEdge, ghostXleftYrightZsameEdge);
+  makeNodeEdgeX_batched(nx, ny, nz, ncomp, ghostYleftFace, ghostYrightFace, ghostXsameYrightZrightEdge, ghostXsameYleftZleftEdge, ghostXsameYleftZrightEdge, ghostXsameYrightZleftEdge);
+
+  // communicate twice each direction
+  communicateGhostFace((ny - 2) * ncomp, vct->getCartesian_rank(), vct->getXright_neighbor_P(), vct->getXleft_neighbor_P(), 0, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightYsameZleftEdge, ghostXleftYsameZleftEdge);
+  communicateGhostFace((ny - 2) * ncomp, vct->getCartesian_rank(), vct->getXright_neighbor_P(), vct->getXleft_neighbor_P(), 0, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightYsameZrightEdge, ghostXleftYsameZrightEdge);
+  communicateGhostFace((nz - 2) * ncomp, vct->getCartesian_rank(), vct->getYright_neighbor_P(), vct->getYleft_neighbor_P(), 1, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXleftYrightZsameEdge, ghostXleftYleftZsameEdge);
+  communicateGhostFace((nz - 2) * ncomp, vct->getCartesian_rank(), vct->getYright_neighbor_P(), vct->getYleft_neighbor_P(), 1, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightYrightZsameEdge, ghostXrightYleftZsameEdge);
+  communicateGhostFace((nx - 2) * ncomp, vct->getCartesian_rank(), vct->getZright_neighbor_P(), vct->getZleft_neighbor_P(), 2, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXsameYleftZrightEdge, ghostXsameYleftZleftEdge);
+  communicateGhostFace((nx - 2) * ncomp, vct->getCartesian_rank(), vct->getZright_neighbor_P(), vct->getZleft_neighbor_P(), 2, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXsameYrightZrightEdge, ghostXsameYrightZleftEdge);
+  addEdgeZ_batched(nx, ny, nz, vectors, ncomp, ghostXrightYrightZsameEdge, ghostXleftYleftZsameEdge, ghostXrightYleftZsameEdge, ghostXleftYrightZsameEdge, vct);
+  addEdgeY_batched(nx, ny, nz, vectors, ncomp, ghostXrightYsameZrightEdge, ghostXleftYsameZleftEdge, ghostXleftYsameZrightEdge, ghostXrightYsameZleftEdge, vct);
+  addEdgeX_batched(nx, ny, nz, vectors, ncomp, ghostXsameYrightZrightEdge, ghostXsameYleftZleftEdge, ghostXsameYleftZrightEdge, ghostXsameYrightZleftEdge, vct);
+
+  makeNodeCorner_batched(nx, ny, nz, ncomp, ghostXsameYrightZrightEdge, ghostXsameYleftZleftEdge, ghostXsameYleftZrightEdge, ghostXsameYrightZleftEdge, ghostXrightYrightZrightCorner, ghostXleftYrightZrightCorner, ghostXrightYleftZrightCorner, ghostXleftYleftZrightCorner, ghostXrightYrightZleftCorner, ghostXleftYrightZleftCorner, ghostXrightYleftZleftCorner, ghostXleftYleftZleftCorner);
+  // communicate only in the X-DIRECTION
+  communicateGhostFace(ncomp, vct->getCartesian_rank(), vct->getXright_neighbor_P(), vct->getXleft_neighbor_P(), 0, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightYrightZrightCorner, ghostXleftYrightZrightCorner);
+  communicateGhostFace(ncomp, vct->getCartesian_rank(), vct->getXright_neighbor_P(), vct->getXleft_neighbor_P(), 0, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightYleftZrightCorner, ghostXleftYleftZrightCorner);
+  communicateGhostFace(ncomp, vct->getCartesian_rank(), vct->getXright_neighbor_P(), vct->getXleft_neighbor_P(), 0, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightYleftZleftCorner, ghostXleftYleftZleftCorner);
+  communicateGhostFace(ncomp, vct->getCartesian_rank(), vct->getXright_neighbor_P(), vct->getXleft_neighbor_P(), 0, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightYrightZleftCorner, ghostXleftYrightZleftCorner);
+  addCorner_batched(nx, ny, nz, vectors, ncomp, ghostXrightYrightZrightCorner, ghostXleftYrightZrightCorner, ghostXrightYleftZrightCorner, ghostXleftYleftZrightCorner, ghostXrightYrightZleftCorner, ghostXleftYrightZleftCorner, ghostXrightYleftZleftCorner, ghostXleftYleftZleftCorner, vct);
+
+  // X EDGE
+  delete[]ghostXsameYleftZleftEdge;
+  delete[]ghostXsameYrightZleftEdge;
+  delete[]ghostXsameYleftZrightEdge;
+  delete[]ghostXsameYrightZrightEdge;
+  // Y EDGE
+  delete[]ghostXrightYsameZleftEdge;
+  delete[]ghostXleftYsameZleftEdge;
+  delete[]ghostXrightYsameZrightEdge;
+  delete[]ghostXleftYsameZrightEdge;
+  // Z EDGE
+  delete[]ghostXrightYleftZsameEdge;
+  delete[]ghostXrightYrightZsameEdge;
+  delete[]ghostXleftYleftZsameEdge;
+  delete[]ghostXleftYrightZsameEdge;
+  // CORNER
+  delete[]ghostXrightYrightZrightCorner;
+  delete[]ghostXleftYrightZrightCorner;
+  delete[]ghostXrightYleftZrightCorner;
+  delete[]ghostXleftYleftZrightCorner;
+  delete[]ghostXrightYrightZleftCorner;
+  delete[]ghostXleftYrightZleftCorner;
+  delete[]ghostXrightYleftZleftCorner;
+  delete[]ghostXleftYleftZleftCorner;
+}
+
+/** communicate ghost cells and sum the contributions of ncomp node
+    arrays at once (e.g. all moments of all species), so that each
+    exchange of communicateInterp() is done with a single message */
+void communicateInterp_batched(int nx, int ny, int nz, int ncomp, double ***const *vectors, VirtualTopology3D * vct) {
+  BatchedInterpExchange exchange(nx, ny, nz, ncomp, vectors, vct);
+  exchange.begin();
+  exchange.end();
+}
@@ -1071,3 +1071,150 @@ void communicateCenterBC_P(int nx, int ny, int nz, arr3_double _vector, int bcFa
   delete[]ghostXleftYleftZsameEdge;
   delete[]ghostXleftYrightZsameEdge;
 }
+
+/** communicate ghost cells of ncomp arrays at once, filling the ghost
+    faces from layer 'layer' of the neighbors (2 for nodes, 1 for centers) */
+static void communicateGhost_batched(int nx, int ny, int nz, int ncomp, double ***const *vectors, int layer, VirtualTopology3D * vct) {
+  // allocate 6 ghost cell Faces
+  double *ghostXrightFace = new double[(ny - 2) * (nz - 2) * ncomp];
+  double *ghostXleftFace = new double[(ny - 2) * (nz - 2) * ncomp];
+  double *ghostYrightFace = new double[(nx - 2) * (nz - 2) * ncomp];
+  double *ghostYleftFace = new double[(nx - 2) * (nz - 2) * ncomp];
+  double *ghostZrightFace = new double[(nx - 2) * (ny - 2) * ncomp];
+  double *ghostZleftFace = new double[(nx - 2) * (ny - 2) * ncomp];
+  // allocate 12 ghost cell Edges
+  // X EDGE
+  double *ghostXsameYleftZleftEdge = new double[(nx - 2) * ncomp];
+  double *ghostXsameYrightZleftEdge = new double[(nx - 2) * ncomp];
+  double *ghostXsameYleftZrightEdge = new double[(nx - 2) * ncomp];
+  double *ghostXsameYrightZrightEdge = new double[(nx - 2) * ncomp];
+  // Y EDGE
+  double *ghostXrightYsameZleftEdge = new double[(ny - 2) * ncomp];
+  double *ghostXleftYsameZleftEdge = new double[(ny - 2) * ncomp];
+  double *ghostXrightYsameZrightEdge = new double[(ny - 2) * ncomp];
+  double *ghostXleftYsameZrightEdge = new double[(ny - 2) * ncomp];
+  // Z EDGE
+  double *ghostXrightYleftZsameEdge = new double[(nz - 2) * ncomp];
+  double *ghostXrightYrightZsameEdge = new double[(nz - 2) * ncomp];
+  double *ghostXleftYleftZsameEdge = new double[(nz - 2) * ncomp];
+  double *ghostXleftYrightZsameEdge = new double[(nz - 2) * ncomp];
+  // allocate 8 ghost cell corner
+  double *ghostXrightYrightZrightCorner = new double[ncomp];
+  double *ghostXleftYrightZrightCorner = new double[ncomp];
+  double *ghostXrightYleftZrightCorner = new double[ncomp];
+  double *ghostXleftYleftZrightCorner = new double[ncomp];
+  double *ghostXrightYrightZleftCorner = new double[ncomp];
+  double *ghostXleftYrightZleftCorner = new double[ncomp];
+  double *ghostXrightYleftZleftCorner = new double[ncomp];
+  double *ghostXleftYleftZleftCorner = new double[ncomp];
+
+  // apply boundary condition to 6 Ghost Faces and communicate if necessary to 6 processors: along 3 DIRECTIONS
+  makeFace_batched(nx, ny, nz, vectors, ncomp, layer, ghostXrightFace, ghostXleftFace, ghostYrightFace, ghostYleftFace, ghostZrightFace, ghostZleftFace);
+  communicateGhostFace((ny - 2) * (nz - 2) * ncomp, vct->getCartesian_rank(), vct->getXright_neighbor_P(), vct->getXleft_neighbor_P(), 0, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightFace, ghostXleftFace);
+  communicateGhostFace((nx - 2) * (nz - 2) * ncomp, vct->getCartesian_rank(), vct->getYright_neighbor_P(), vct->getYleft_neighbor_P(), 1, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostYrightFace, ghostYleftFace);
+  communicateGhostFace((nx - 2) * (ny - 2) * ncomp, vct->getCartesian_rank(), vct->getZright_neighbor_P(), vct->getZleft_neighbor_P(), 2, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostZrightFace, ghostZleftFace);
+  parseFace_batched(nx, ny, nz, vectors, ncomp, ghostXrightFace, ghostXleftFace, ghostYrightFace, ghostYleftFace, ghostZrightFace, ghostZleftFace);
+
+  makeNodeEdgeY_batched(nx, ny, nz, ncomp, ghostZleftFace, ghostZrightFace, ghostXrightYsameZrightEdge, ghostXleftYsameZleftEdge, ghostXleftYsameZrightEdge, ghostXrightYsameZleftEdge);
+  makeNodeEdgeZ_batched(nx, ny, nz, ncomp, ghostXleftFace, ghostXrightFace, ghostXrightYrightZsameEdge, ghostXleftYleftZsameEdge, ghostXrightYleftZsameEdge, ghostXleftYrightZsameEdge);
+  makeNodeEdgeX_batched(nx, ny, nz, ncomp, ghostYleftFace, ghostYrightFace, ghostXsameYrightZrightEdge, ghostXsameYleftZleftEdge, ghostXsameYleftZrightEdge, ghostXsameYrightZleftEdge);
+
+  // communicate twice each direction
+  communicateGhostFace((ny - 2) * ncomp, vct->getCartesian_rank(), vct->getXright_neighbor_P(), vct->getXleft_neighbor_P(), 0, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightYsameZleftEdge, ghostXleftYsameZleftEdge);
+  communicateGhostFace((ny - 2) * ncomp, vct->getCartesian_rank(), vct->getXright_neighbor_P(), vct->getXleft_neighbor_P(), 0, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightYsameZrightEdge, ghostXleftYsameZrightEdge);
+  communicateGhostFace((nz - 2) * ncomp, vct->getCartesian_rank(), vct->getYright_neighbor_P(), vct->getYleft_neighbor_P(), 1, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXleftYrightZsameEdge, ghostXleftYleftZsameEdge);
+  communicateGhostFace((nz - 2) * ncomp, vct->getCartesian_rank(), vct->getYright_neighbor_P(), vct->getYleft_neighbor_P(), 1, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightYrightZsameEdge, ghostXrightYleftZsameEdge);
+  communicateGhostFace((nx - 2) * ncomp, vct->getCartesian_rank(), vct->getZright_neighbor_P(), vct->getZleft_neighbor_P(), 2, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXsameYleftZrightEdge, ghostXsameYleftZleftEdge);
+  communicateGhostFace((nx - 2) * ncomp, vct->getCartesian_rank(), vct->getZright_neighbor_P(), vct->getZleft_neighbor_P(), 2, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXsameYrightZrightEdge, ghostXsameYrightZleftEdge);
+  parseEdgeZ_batched(nx, ny, nz, vectors, ncomp, ghostXrightYrightZsameEdge, ghostXleftYleftZsameEdge, ghostXrightYleftZsameEdge, ghostXleftYrightZsameEdge);
+  parseEdgeY_batched(nx, ny, nz, vectors, ncomp, ghostXrightYsameZrightEdge, ghostXleftYsameZleftEdge, ghostXleftYsameZrightEdge, ghostXrightYsameZleftEdge);
+  parseEdgeX_batched(nx, ny, nz, vectors, ncomp, ghostXsameYrightZrightEdge, ghostXsameYleftZleftEdge, ghostXsameYleftZrightEdge, ghostXsameYrightZleftEdge);
+
+  makeNodeCorner_batched(nx, ny, nz, ncomp, ghostXsameYrightZrightEdge, ghostXsameYleftZleftEdge, ghostXsameYleftZrightEdge, ghostXsameYrightZleftEdge, ghostXrightYrightZrightCorner, ghostXleftYrightZrightCorner, ghostXrightYleftZrightCorner, ghostXleftYleftZrightCorner, ghostXrightYrightZleftCorner, ghostXleftYrightZleftCorner, ghostXrightYleftZleftCorner, ghostXleftYleftZleftCorner);
+  // communicate only in the X-DIRECTION
+  communicateGhostFace(ncomp, vct->getCartesian_rank(), vct->getXright_neighbor_P(), vct->getXleft_neighbor_P(), 0, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightYrightZrightCorner, ghostXleftYrightZrightCorner);
+  communicateGhostFace(ncomp, vct->getCartesian_rank(), vct->getXright_neighbor_P(), vct->getXleft_neighbor_P(), 0, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightYleftZrightCorner, ghostXleftYleftZrightCorner);
+  communicateGhostFace(ncomp, vct->getCartesian_rank(), vct->getXright_neighbor_P(), vct->getXleft_neighbor_P(), 0, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightYleftZleftCorner, ghostXleftYleftZleftCorner);
+  communicateGhostFace(ncomp, vct->getCartesian_rank(), vct->getXright_neighbor_P(), vct->getXleft_neighbor_P(), 0, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightYrightZleftCorner, ghostXleftYrightZleftCorner);
+  parseCorner_batched(nx, ny, nz, vectors, ncomp, ghostXrightYrightZrightCorner, ghostXleftYrightZrightCorner, ghostXrightYleftZrightCorner, ghostXleftYleftZrightCorner, ghostXrightYrightZleftCorner, ghostXleftYrightZleftCorner, ghostXrightYleftZleftCorner, ghostXleftYleftZleftCorner);
+
+  delete[]ghostXrightFace;
+  delete[]ghostXleftFace;
+  delete[]ghostYrightFace;
+  delete[]ghostYleftFace;
+  delete[]ghostZrightFace;
+  delete[]ghostZleftFace;
+  // X EDGE
+  delete[]ghostXsameYleftZleftEdge;
+  delete[]ghostXsameYrightZleftEdge;
+  delete[]ghostXsameYleftZrightEdge;
+  delete[]ghostXsameYrightZrightEdge;
+  // Y EDGE
+  delete[]ghostXrightYsameZleftEdge;
+  delete[]ghostXleftYsameZleftEdge;
+  delete[]ghostXrightYsameZrightEdge;
+  delete[]ghostXleftYsameZrightEdge;
+  // Z EDGE
+  delete[]ghostXrightYleftZsameEdge;
+  delete[]ghostXrightYrightZsameEdge;
+  delete[]ghostXleftYleftZsameEdge;
+  delete[]ghostXleftYrightZsameEdge;
+  // CORNER
+  delete[]ghostXrightYrightZrightCorner;
+  delete[]ghostXleftYrightZrightCorner;
+  delete[]ghostXrightYleftZrightCorner;
+  delete[]ghostXleftYleftZrightCorner;
+  delete[]ghostXrightYrightZleftCorner;
+  delete[]ghostXleftYrightZleftCorner;
+  delete[]ghostXrightYleftZleftCorner;
+  delete[]ghostXleftYleftZleftCorner;
+}
+
+/** communicate ghost cells of ncomp node arrays at once
+    (as communicateNode_P() does for each array) */
+void communicateNode_P_batched(int nx, int ny, int nz, int ncomp, double ***const *vectors, VirtualTopology3D * vct) {
+  timeTasks_set_communicating();
+  communicateGhost_batched(nx, ny, nz, ncomp, vectors, 2, vct);
+}
+
+/** communicate ghost cells of ncomp center arrays at once and apply
+    boundary conditions (as communicateCenterBC_P() does for each array) */
+void communicateCenterBC_P_batched(int nx, int ny, int nz, int ncomp, double ***const *vectors, int bcFaceXright, int bcFaceXleft, int bcFaceYright, int bcFaceYleft, int bcFaceZright, int bcFaceZleft, VirtualTopology3D * vct) {
+  timeTasks_set_communicating();
+  communicateGhost_batched(nx, ny, nz, ncomp, vectors, 1, vct);
+  for (int c = 0; c < ncomp; c++)
+    BCface_P(nx, ny, nz, vectors[c], bcFaceXright, bcFaceXleft, bcFaceYright, bcFaceYleft, bcFaceZright, bcFaceZleft, vct);
+}
+
+/** communicate ghost faces of ncomp node arrays at once and apply
+    boundary conditions (as communicateNodeBoxStencilBC_P() does for each array) */
+void communicateNodeBoxStencilBC_P_batched(int nx, int ny, int nz, int ncomp, double ***const *vectors, int bcFaceXright, int bcFaceXleft, int bcFaceYright, int bcFaceYleft, int bcFaceZright, int bcFaceZleft, VirtualTopology3D * vct) {
+  timeTasks_set_communicating();
+  // allocate 6 ghost cell Faces
+  double *ghostXrightFace = new double[(ny - 2) * (nz - 2) * ncomp];
+  double *ghostXleftFace = new double[(ny - 2) * (nz - 2) * ncomp];
+  double *ghostYrightFace = new double[(nx - 2) * (nz - 2) * ncomp];
+  double *ghostYleftFace = new double[(nx - 2) * (nz - 2) * ncomp];
+  double *ghostZrightFace = new double[(nx - 2) * (ny - 2) * ncomp];
+  double *ghostZleftFace = new double[(nx - 2) * (ny - 2) * ncomp];
+
+  // apply boundary condition to 6 Ghost Faces and communicate if necessary to 6 processors: along 3 DIRECTIONS
+  makeFace_batched(nx, ny, nz, vectors, ncomp, 2, ghostXrightFace, ghostXleftFace, ghostYrightFace, ghostYleftFace, ghostZrightFace, ghostZleftFace);
+  communicateGhostFace((ny - 2) * (nz - 2) * ncomp, vct->getCartesian_rank(), vct->getXright_neighbor_P(), vct->getXleft_neighbor_P(), 0, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostXrightFace, ghostXleftFace);
+  communicateGhostFace((nx - 2) * (nz - 2) * ncomp, vct->getCartesian_rank(), vct->getYright_neighbor_P(), vct->getYleft_neighbor_P(), 1, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostYrightFace, ghostYleftFace);
+  communicateGhostFace((nx - 2) * (ny - 2) * ncomp, vct->getCartesian_rank(), vct->getZright_neighbor_P(), vct->getZleft_neighbor_P(), 2, vct->getXLEN(), vct->getYLEN(), vct->getZLEN(), ghostZrightFace, ghostZleftFace);
+  parseFace_batched(nx, ny, nz, vectors, ncomp, ghostXrightFace, ghostXleftFace, ghostYrightFace, ghostYleftFace, ghostZrightFace, ghostZleftFace);
+
+  // ////////////////////////////////////////////////////////////////////////
+  // ///////////////// APPLY the boundary conditions ////////////////////////
+  // ////////////////////////////////////////////////////////////////////////
+  for (int c = 0; c < ncomp; c++)
+    BCface_P(nx, ny, nz, vectors[c], bcFaceXright, bcFaceXleft, bcFaceYright, bcFaceYleft, bcFaceZright, bcFaceZleft, vct);
+  // deallocate
+  delete[]ghostXrightFace;
+  delete[]ghostXleftFace;
+  delete[]ghostYrightFace;
+  delete[]ghostYleftFace;
+  delete[]ghostZrightFace;
+  delete[]ghostZleftFace;
+}
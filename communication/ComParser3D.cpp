@@ -662,3 +662,340 @@ void addCorner(int nx, int ny, int nz, double ****vector, int ns, double *ghostX
   if (vct->getXleft_neighbor_P() != MPI_PROC_NULL && vct->getYleft_neighbor_P() != MPI_PROC_NULL && vct->getZleft_neighbor_P() != MPI_PROC_NULL)
     vector[ns][1][1][1] += *ghostXleftYleftZleftCorner;
 }
+
+// ////////////////////////////
+// ////////////////////////////
+// BATCHED
+// ////////////////////////////
+// ////////////////////////////
+//
+// The following variants operate on a list of ncomp node arrays
+// (e.g. all moments of all species) at once.  Buffers hold the
+// ncomp values of each ghost node contiguously, so that a single
+// message carries all the arrays.
+//
+static inline void copyComponents(double *dst, const double *src, int ncomp) {
+  for (int c = 0; c < ncomp; c++)
+    dst[c] = src[c];
+}
+static inline void getNode(double *buf, double ***const *vectors, int ncomp, int i, int j, int k) {
+  for (int c = 0; c < ncomp; c++)
+    buf[c] = vectors[c][i][j][k];
+}
+static inline void setNode(double ***const *vectors, int ncomp, int i, int j, int k, const double *buf) {
+  for (int c = 0; c < ncomp; c++)
+    vectors[c][i][j][k] = buf[c];
+}
+static inline void addNode(double ***const *vectors, int ncomp, int i, int j, int k, const double *buf) {
+  for (int c = 0; c < ncomp; c++)
+    vectors[c][i][j][k] += buf[c];
+}
+
+/** BATCHED: prepare faces of nodes layer and n-1-layer for communication */
+void makeFace_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, int layer, double *ghostXrightFace, double *ghostXleftFace, double *ghostYrightFace, double *ghostYleftFace, double *ghostZrightFace, double *ghostZleftFace) {
+  // XFACES
+  int counter = 0;
+  for (int j = 1; j < ny - 1; j++)
+    for (int k = 1; k < nz - 1; k++) {
+      getNode(&ghostXleftFace[counter * ncomp], vectors, ncomp, layer, j, k);
+      getNode(&ghostXrightFace[counter * ncomp], vectors, ncomp, nx - 1 - layer, j, k);
+      counter++;
+    }
+  // YFACES
+  counter = 0;
+  for (int i = 1; i < nx - 1; i++)
+    for (int k = 1; k < nz - 1; k++) {
+      getNode(&ghostYleftFace[counter * ncomp], vectors, ncomp, i, layer, k);
+      getNode(&ghostYrightFace[counter * ncomp], vectors, ncomp, i, ny - 1 - layer, k);
+      counter++;
+    }
+  // ZFACES
+  counter = 0;
+  for (int i = 1; i < nx - 1; i++)
+    for (int j = 1; j < ny - 1; j++) {
+      getNode(&ghostZleftFace[counter * ncomp], vectors, ncomp, i, j, layer);
+      getNode(&ghostZrightFace[counter * ncomp], vectors, ncomp, i, j, nz - 1 - layer);
+      counter++;
+    }
+}
+
+/** BATCHED: insert the ghost cells faces in the node arrays */
+void parseFace_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXrightFace, double *ghostXleftFace, double *ghostYrightFace, double *ghostYleftFace, double *ghostZrightFace, double *ghostZleftFace) {
+  // XFACES
+  int counter = 0;
+  for (int j = 1; j < ny - 1; j++)
+    for (int k = 1; k < nz - 1; k++) {
+      setNode(vectors, ncomp, 0, j, k, &ghostXleftFace[counter * ncomp]);
+      setNode(vectors, ncomp, nx - 1, j, k, &ghostXrightFace[counter * ncomp]);
+      counter++;
+    }
+  // YFACES
+  counter = 0;
+  for (int i = 1; i < nx - 1; i++)
+    for (int k = 1; k < nz - 1; k++) {
+      setNode(vectors, ncomp, i, 0, k, &ghostYleftFace[counter * ncomp]);
+      setNode(vectors, ncomp, i, ny - 1, k, &ghostYrightFace[counter * ncomp]);
+      counter++;
+    }
+  // ZFACES
+  counter = 0;
+  for (int i = 1; i < nx - 1; i++)
+    for (int j = 1; j < ny - 1; j++) {
+      setNode(vectors, ncomp, i, j, 0, &ghostZleftFace[counter * ncomp]);
+      setNode(vectors, ncomp, i, j, nz - 1, &ghostZrightFace[counter * ncomp]);
+      counter++;
+    }
+}
+
+/** BATCHED: add the values of ghost cells faces to the node arrays */
+void addFace_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXrightFace, double *ghostXleftFace, double *ghostYrightFace, double *ghostYleftFace, double *ghostZrightFace, double *ghostZleftFace, VirtualTopology3D * vct) {
+  int counter;
+  if (vct->getXright_neighbor_P() != MPI_PROC_NULL) { // XRIGHT
+    counter = 0;
+    for (int j = 1; j < ny - 1; j++)
+      for (int k = 1; k < nz - 1; k++) {
+        addNode(vectors, ncomp, nx - 2, j, k, &ghostXrightFace[counter * ncomp]);
+        counter++;
+      }
+  }
+  if (vct->getXleft_neighbor_P() != MPI_PROC_NULL) {  // XLEFT
+    counter = 0;
+    for (int j = 1; j < ny - 1; j++)
+      for (int k = 1; k < nz - 1; k++) {
+        addNode(vectors, ncomp, 1, j, k, &ghostXleftFace[counter * ncomp]);
+        counter++;
+      }
+  }
+  if (vct->getYright_neighbor_P() != MPI_PROC_NULL) { // YRIGHT
+    counter = 0;
+    for (int i = 1; i < nx - 1; i++)
+      for (int k = 1; k < nz - 1; k++) {
+        addNode(vectors, ncomp, i, ny - 2, k, &ghostYrightFace[counter * ncomp]);
+        counter++;
+      }
+  }
+  if (vct->getYleft_neighbor_P() != MPI_PROC_NULL) {  // YLEFT
+    counter = 0;
+    for (int i = 1; i < nx - 1; i++)
+      for (int k = 1; k < nz - 1; k++) {
+        addNode(vectors, ncomp, i, 1, k, &ghostYleftFace[counter * ncomp]);
+        counter++;
+      }
+  }
+  if (vct->getZright_neighbor_P() != MPI_PROC_NULL) { // ZRIGHT
+    counter = 0;
+    for (int i = 1; i < nx - 1; i++)
+      for (int j = 1; j < ny - 1; j++) {
+        addNode(vectors, ncomp, i, j, nz - 2, &ghostZrightFace[counter * ncomp]);
+        counter++;
+      }
+  }
+  if (vct->getZleft_neighbor_P() != MPI_PROC_NULL) {  // ZLEFT
+    counter = 0;
+    for (int i = 1; i < nx - 1; i++)
+      for (int j = 1; j < ny - 1; j++) {
+        addNode(vectors, ncomp, i, j, 1, &ghostZleftFace[counter * ncomp]);
+        counter++;
+      }
+  }
+}
+
+/** BATCHED: prepare ghost cell Edge Z for communication: these are communicated in Y direction */
+void makeNodeEdgeZ_batched(int nx, int ny, int nz, int ncomp, double *faceXleft, double *faceXright, double *ghostXrightYrightZsameEdge, double *ghostXleftYleftZsameEdge, double *ghostXrightYleftZsameEdge, double *ghostXleftYrightZsameEdge) {
+  int counter = 0;
+  int counterLeft = 0;
+  int counterRight = 0;
+  for (int j = 1; j < ny - 1; j++)
+    for (int k = 1; k < nz - 1; k++) {
+      if (j == 1) {             // YLEFT
+        copyComponents(&ghostXleftYleftZsameEdge[counterLeft * ncomp], &faceXleft[counter * ncomp], ncomp);
+        copyComponents(&ghostXrightYleftZsameEdge[counterLeft * ncomp], &faceXright[counter * ncomp], ncomp);
+        counterLeft++;
+      }
+      if (j == ny - 2) {        // YRIGHT
+        copyComponents(&ghostXleftYrightZsameEdge[counterRight * ncomp], &faceXleft[counter * ncomp], ncomp);
+        copyComponents(&ghostXrightYrightZsameEdge[counterRight * ncomp], &faceXright[counter * ncomp], ncomp);
+        counterRight++;
+      }
+      counter++;
+    }
+}
+
+/** BATCHED: prepare ghost cell Edge Y for communication: these are communicated in X direction */
+void makeNodeEdgeY_batched(int nx, int ny, int nz, int ncomp, double *faceZleft, double *faceZright, double *ghostXrightYsameZrightEdge, double *ghostXleftYsameZleftEdge, double *ghostXleftYsameZrightEdge, double *ghostXrightYsameZleftEdge) {
+  int counter = 0;
+  int counterLeft = 0;
+  int counterRight = 0;
+  for (int i = 1; i < nx - 1; i++)
+    for (int j = 1; j < ny - 1; j++) {
+      if (i == 1) {             // XLEFT
+        copyComponents(&ghostXleftYsameZleftEdge[counterLeft * ncomp], &faceZleft[counter * ncomp], ncomp);
+        copyComponents(&ghostXleftYsameZrightEdge[counterLeft * ncomp], &faceZright[counter * ncomp], ncomp);
+        counterLeft++;
+      }
+      if (i == nx - 2) {        // XRIGHT
+        copyComponents(&ghostXrightYsameZleftEdge[counterRight * ncomp], &faceZleft[counter * ncomp], ncomp);
+        copyComponents(&ghostXrightYsameZrightEdge[counterRight * ncomp], &faceZright[counter * ncomp], ncomp);
+        counterRight++;
+      }
+      counter++;
+    }
+}
+
+/** BATCHED: prepare ghost cell Edge X for communication: these are communicated in Z direction */
+void makeNodeEdgeX_batched(int nx, int ny, int nz, int ncomp, double *faceYleft, double *faceYright, double *ghostXsameYrightZrightEdge, double *ghostXsameYleftZleftEdge, double *ghostXsameYleftZrightEdge, double *ghostXsameYrightZleftEdge) {
+  int counter = 0;
+  int counterLeft = 0;
+  int counterRight = 0;
+  for (int i = 1; i < nx - 1; i++)
+    for (int k = 1; k < nz - 1; k++) {
+      if (k == 1) {             // ZLEFT
+        copyComponents(&ghostXsameYleftZleftEdge[counterLeft * ncomp], &faceYleft[counter * ncomp], ncomp);
+        copyComponents(&ghostXsameYrightZleftEdge[counterLeft * ncomp], &faceYright[counter * ncomp], ncomp);
+        counterLeft++;
+      }
+      if (k == nz - 2) {        // ZRIGHT
+        copyComponents(&ghostXsameYleftZrightEdge[counterRight * ncomp], &faceYleft[counter * ncomp], ncomp);
+        copyComponents(&ghostXsameYrightZrightEdge[counterRight * ncomp], &faceYright[counter * ncomp], ncomp);
+        counterRight++;
+      }
+      counter++;
+    }
+}
+
+/** BATCHED: prepare ghost cell corners for communication */
+void makeNodeCorner_batched(int nx, int ny, int nz, int ncomp, double *ghostXsameYrightZrightEdge, double *ghostXsameYleftZleftEdge, double *ghostXsameYleftZrightEdge, double *ghostXsameYrightZleftEdge, double *ghostXrightYrightZrightCorner, double *ghostXleftYrightZrightCorner, double *ghostXrightYleftZrightCorner, double *ghostXleftYleftZrightCorner, double *ghostXrightYrightZleftCorner, double *ghostXleftYrightZleftCorner, double *ghostXrightYleftZleftCorner, double *ghostXleftYleftZleftCorner) {
+  copyComponents(ghostXleftYrightZrightCorner, &ghostXsameYrightZrightEdge[0], ncomp);
+  copyComponents(ghostXrightYrightZrightCorner, &ghostXsameYrightZrightEdge[(nx - 3) * ncomp], ncomp);
+
+  copyComponents(ghostXleftYleftZrightCorner, &ghostXsameYleftZrightEdge[0], ncomp);
+  copyComponents(ghostXrightYleftZrightCorner, &ghostXsameYleftZrightEdge[(nx - 3) * ncomp], ncomp);
+
+  copyComponents(ghostXleftYrightZleftCorner, &ghostXsameYrightZleftEdge[0], ncomp);
+  copyComponents(ghostXrightYrightZleftCorner, &ghostXsameYrightZleftEdge[(nx - 3) * ncomp], ncomp);
+
+  copyComponents(ghostXleftYleftZleftCorner, &ghostXsameYleftZleftEdge[0], ncomp);
+  copyComponents(ghostXrightYleftZleftCorner, &ghostXsameYleftZleftEdge[(nx - 3) * ncomp], ncomp);
+}
+
+/** BATCHED: insert the ghost cells Edge Z in the node arrays */
+void parseEdgeZ_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXrightYrightZsameEdge, double *ghostXleftYleftZsameEdge, double *ghostXrightYleftZsameEdge, double *ghostXleftYrightZsameEdge) {
+  for (int i = 1; i < (nz - 1); i++) {
+    setNode(vectors, ncomp, nx - 1, ny - 1, i, &ghostXrightYrightZsameEdge[(i - 1) * ncomp]);
+    setNode(vectors, ncomp, 0, 0, i, &ghostXleftYleftZsameEdge[(i - 1) * ncomp]);
+    setNode(vectors, ncomp, nx - 1, 0, i, &ghostXrightYleftZsameEdge[(i - 1) * ncomp]);
+    setNode(vectors, ncomp, 0, ny - 1, i, &ghostXleftYrightZsameEdge[(i - 1) * ncomp]);
+  }
+}
+
+/** BATCHED: insert the ghost cells Edge Y in the node arrays */
+void parseEdgeY_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXrightYsameZrightEdge, double *ghostXleftYsameZleftEdge, double *ghostXleftYsameZrightEdge, double *ghostXrightYsameZleftEdge) {
+  for (int i = 1; i < (ny - 1); i++) {
+    setNode(vectors, ncomp, nx - 1, i, nz - 1, &ghostXrightYsameZrightEdge[(i - 1) * ncomp]);
+    setNode(vectors, ncomp, 0, i, 0, &ghostXleftYsameZleftEdge[(i - 1) * ncomp]);
+    setNode(vectors, ncomp, 0, i, nz - 1, &ghostXleftYsameZrightEdge[(i - 1) * ncomp]);
+    setNode(vectors, ncomp, nx - 1, i, 0, &ghostXrightYsameZleftEdge[(i - 1) * ncomp]);
+  }
+}
+
+/** BATCHED: insert the ghost cells Edge X in the node arrays */
+void parseEdgeX_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXsameYrightZrightEdge, double *ghostXsameYleftZleftEdge, double *ghostXsameYleftZrightEdge, double *ghostXsameYrightZleftEdge) {
+  for (int i = 1; i < (nx - 1); i++) {
+    setNode(vectors, ncomp, i, ny - 1, nz - 1, &ghostXsameYrightZrightEdge[(i - 1) * ncomp]);
+    setNode(vectors, ncomp, i, 0, 0, &ghostXsameYleftZleftEdge[(i - 1) * ncomp]);
+    setNode(vectors, ncomp, i, 0, nz - 1, &ghostXsameYleftZrightEdge[(i - 1) * ncomp]);
+    setNode(vectors, ncomp, i, ny - 1, 0, &ghostXsameYrightZleftEdge[(i - 1) * ncomp]);
+  }
+}
+
+/** BATCHED: add the ghost cell values Edge Z to the node arrays */
+void addEdgeZ_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXrightYrightZsameEdge, double *ghostXleftYleftZsameEdge, double *ghostXrightYleftZsameEdge, double *ghostXleftYrightZsameEdge, VirtualTopology3D * vct) {
+  if (vct->getXright_neighbor_P() != MPI_PROC_NULL && vct->getYright_neighbor_P() != MPI_PROC_NULL) {
+    for (int i = 1; i < (nz - 1); i++)
+      addNode(vectors, ncomp, nx - 2, ny - 2, i, &ghostXrightYrightZsameEdge[(i - 1) * ncomp]);
+  }
+  if (vct->getXleft_neighbor_P() != MPI_PROC_NULL && vct->getYleft_neighbor_P() != MPI_PROC_NULL) {
+    for (int i = 1; i < (nz - 1); i++)
+      addNode(vectors, ncomp, 1, 1, i, &ghostXleftYleftZsameEdge[(i - 1) * ncomp]);
+  }
+  if (vct->getXright_neighbor_P() != MPI_PROC_NULL && vct->getYleft_neighbor_P() != MPI_PROC_NULL) {
+    for (int i = 1; i < (nz - 1); i++)
+      addNode(vectors, ncomp, nx - 2, 1, i, &ghostXrightYleftZsameEdge[(i - 1) * ncomp]);
+  }
+  if (vct->getXleft_neighbor_P() != MPI_PROC_NULL && vct->getYright_neighbor_P() != MPI_PROC_NULL) {
+    for (int i = 1; i < (nz - 1); i++)
+      addNode(vectors, ncomp, 1, ny - 2, i, &ghostXleftYrightZsameEdge[(i - 1) * ncomp]);
+  }
+}
+
+/** BATCHED: add the ghost cell values Edge Y to the node arrays */
+void addEdgeY_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXrightYsameZrightEdge, double *ghostXleftYsameZleftEdge, double *ghostXleftYsameZrightEdge, double *ghostXrightYsameZleftEdge, VirtualTopology3D * vct) {
+  if (vct->getXright_neighbor_P() != MPI_PROC_NULL && vct->getZright_neighbor_P() != MPI_PROC_NULL) {
+    for (int i = 1; i < (ny - 1); i++)
+      addNode(vectors, ncomp, nx - 2, i, nz - 2, &ghostXrightYsameZrightEdge[(i - 1) * ncomp]);
+  }
+  if (vct->getXleft_neighbor_P() != MPI_PROC_NULL && vct->getZleft_neighbor_P() != MPI_PROC_NULL) {
+    for (int i = 1; i < (ny - 1); i++)
+      addNode(vectors, ncomp, 1, i, 1, &ghostXleftYsameZleftEdge[(i - 1) * ncomp]);
+  }
+  if (vct->getXleft_neighbor_P() != MPI_PROC_NULL && vct->getZright_neighbor_P() != MPI_PROC_NULL) {
+    for (int i = 1; i < (ny - 1); i++)
+      addNode(vectors, ncomp, 1, i, nz - 2, &ghostXleftYsameZrightEdge[(i - 1) * ncomp]);
+  }
+  if (vct->getXright_neighbor_P() != MPI_PROC_NULL && vct->getZleft_neighbor_P() != MPI_PROC_NULL) {
+    for (int i = 1; i < (ny - 1); i++)
+      addNode(vectors, ncomp, nx - 2, i, 1, &ghostXrightYsameZleftEdge[(i - 1) * ncomp]);
+  }
+}
+
+/** BATCHED: add the ghost cell values Edge X to the node arrays */
+void addEdgeX_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXsameYrightZrightEdge, double *ghostXsameYleftZleftEdge, double *ghostXsameYleftZrightEdge, double *ghostXsameYrightZleftEdge, VirtualTopology3D * vct) {
+  if (vct->getYright_neighbor_P() != MPI_PROC_NULL && vct->getZright_neighbor_P() != MPI_PROC_NULL) {
+    for (int i = 1; i < (nx - 1); i++)
+      addNode(vectors, ncomp, i, ny - 2, nz - 2, &ghostXsameYrightZrightEdge[(i - 1) * ncomp]);
+  }
+  if (vct->getYleft_neighbor_P() != MPI_PROC_NULL && vct->getZleft_neighbor_P() != MPI_PROC_NULL) {
+    for (int i = 1; i < (nx - 1); i++)
+      addNode(vectors, ncomp, i, 1, 1, &ghostXsameYleftZleftEdge[(i - 1) * ncomp]);
+  }
+  if (vct->getYleft_neighbor_P() != MPI_PROC_NULL && vct->getZright_neighbor_P() != MPI_PROC_NULL) {
+    for (int i = 1; i < (nx - 1); i++)
+      addNode(vectors, ncomp, i, 1, nz - 2, &ghostXsameYleftZrightEdge[(i - 1) * ncomp]);
+  }
+  if (vct->getYright_neighbor_P() != MPI_PROC_NULL && vct->getZleft_neighbor_P() != MPI_PROC_NULL) {
+    for (int i = 1; i < (nx - 1); i++)
+      addNode(vectors, ncomp, i, ny - 2, 1, &ghostXsameYrightZleftEdge[(i - 1) * ncomp]);
+  }
+}
+
+/** BATCHED: insert the ghost cell corners in the node arrays */
+void parseCorner_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXrightYrightZrightCorner, double *ghostXleftYrightZrightCorner, double *ghostXrightYleftZrightCorner, double *ghostXleftYleftZrightCorner, double *ghostXrightYrightZleftCorner, double *ghostXleftYrightZleftCorner, double *ghostXrightYleftZleftCorner, double *ghostXleftYleftZleftCorner) {
+  setNode(vectors, ncomp, nx - 1, ny - 1, nz - 1, ghostXrightYrightZrightCorner);
+  setNode(vectors, ncomp, 0, ny - 1, nz - 1, ghostXleftYrightZrightCorner);
+  setNode(vectors, ncomp, nx - 1, 0, nz - 1, ghostXrightYleftZrightCorner);
+  setNode(vectors, ncomp, 0, 0, nz - 1, ghostXleftYleftZrightCorner);
+  setNode(vectors, ncomp, nx - 1, ny - 1, 0, ghostXrightYrightZleftCorner);
+  setNode(vectors, ncomp, 0, ny - 1, 0, ghostXleftYrightZleftCorner);
+  setNode(vectors, ncomp, nx - 1, 0, 0, ghostXrightYleftZleftCorner);
+  setNode(vectors, ncomp, 0, 0, 0, ghostXleftYleftZleftCorner);
+}
+
+/** BATCHED: add the ghost cell corner values to the node arrays */
+void addCorner_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXrightYrightZrightCorner, double *ghostXleftYrightZrightCorner, double *ghostXrightYleftZrightCorner, double *ghostXleftYleftZrightCorner, double *ghostXrightYrightZleftCorner, double *ghostXleftYrightZleftCorner, double *ghostXrightYleftZleftCorner, double *ghostXleftYleftZleftCorner, VirtualTopology3D * vct) {
+  if (vct->getXright_neighbor_P() != MPI_PROC_NULL && vct->getYright_neighbor_P() != MPI_PROC_NULL && vct->getZright_neighbor_P() != MPI_PROC_NULL)
+    addNode(vectors, ncomp, nx - 2, ny - 2, nz - 2, ghostXrightYrightZrightCorner);
+  if (vct->getXleft_neighbor_P() != MPI_PROC_NULL && vct->getYright_neighbor_P() != MPI_PROC_NULL && vct->getZright_neighbor_P() != MPI_PROC_NULL)
+    addNode(vectors, ncomp, 1, ny - 2, nz - 2, ghostXleftYrightZrightCorner);
+  if (vct->getXright_neighbor_P() != MPI_PROC_NULL && vct->getYleft_neighbor_P() != MPI_PROC_NULL && vct->getZright_neighbor_P() != MPI_PROC_NULL)
+    addNode(vectors, ncomp, nx - 2, 1, nz - 2, ghostXrightYleftZrightCorner);
+  if (vct->getXleft_neighbor_P() != MPI_PROC_NULL && vct->getYleft_neighbor_P() != MPI_PROC_NULL && vct->getZright_neighbor_P() != MPI_PROC_NULL)
+    addNode(vectors, ncomp, 1, 1, nz - 2, ghostXleftYleftZrightCorner);
+  if (vct->getXright_neighbor_P() != MPI_PROC_NULL && vct->getYright_neighbor_P() != MPI_PROC_NULL && vct->getZleft_neighbor_P() != MPI_PROC_NULL)
+    addNode(vectors, ncomp, nx - 2, ny - 2, 1, ghostXrightYrightZleftCorner);
+  if (vct->getXleft_neighbor_P() != MPI_PROC_NULL && vct->getYright_neighbor_P() != MPI_PROC_NULL && vct->getZleft_neighbor_P() != MPI_PROC_NULL)
+    addNode(vectors, ncomp, 1, ny - 2, 1, ghostXleftYrightZleftCorner);
+  if (vct->getXright_neighbor_P() != MPI_PROC_NULL && vct->getYleft_neighbor_P() != MPI_PROC_NULL && vct->getZleft_neighbor_P() != MPI_PROC_NULL)
+    addNode(vectors, ncomp, nx - 2, 1, 1, ghostXrightYleftZleftCorner);
+  if (vct->getXleft_neighbor_P() != MPI_PROC_NULL && vct->getYleft_neighbor_P() != MPI_PROC_NULL && vct->getZleft_neighbor_P() != MPI_PROC_NULL)
+    addNode(vectors, ncomp, 1, 1, 1, ghostXleftYleftZleftCorner);
+}
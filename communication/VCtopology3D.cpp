@@ -68,6 +68,32 @@ void VCtopology3D::setup_vctopology(MPI_Comm old_comm) {
     MPI_Cart_shift(CART_COMM, XDIR, RIGHT, &xleft_neighbor, &xright_neighbor);
     MPI_Cart_shift(CART_COMM, YDIR, RIGHT, &yleft_neighbor, &yright_neighbor);
     MPI_Cart_shift(CART_COMM, ZDIR, RIGHT, &zleft_neighbor, &zright_neighbor);
+
+    // neighbors sharing a face, edge, or corner
+    for(int i=0;i<3;i++)
+    for(int j=0;j<3;j++)
+    for(int k=0;k<3;k++)
+    {
+      int nbr_coords[3] = {
+        coordinates[0]+i-1,
+        coordinates[1]+j-1,
+        coordinates[2]+k-1};
+      bool exists = true;
+      for(int dim=0;dim<3;dim++)
+      {
+        if(nbr_coords[dim]<0 || nbr_coords[dim]>=dims[dim])
+        {
+          if(periods[dim])
+            nbr_coords[dim] = (nbr_coords[dim]+dims[dim])%dims[dim];
+          else
+            exists = false;
+        }
+      }
+      if(exists)
+        MPI_Cart_rank(CART_COMM, nbr_coords, &neighbor[i][j][k]);
+      else
+        neighbor[i][j][k] = MPI_PROC_NULL;
+    }
   }
   else {
     // previous check that nprocs = XLEN*YLEN*ZLEN should prevent reaching this line.
@@ -11,6 +11,8 @@
 #include "mic_particles.h"
 #include "ipicmath.h" // for roundup_to_multiple
 #include "Alloc.h"
+#include <algorithm> // for std::min
+#include <float.h> // for DBL_EPSILON
 
 using namespace iPic3D;
 
@@ -109,6 +111,9 @@ EMfields3D::EMfields3D(Collective * col, Grid * grid) :
   tempXN (nxn, nyn, nzn),
   tempYN (nxn, nyn, nzn),
   tempZN (nxn, nyn, nzn),
+  divPXC (ns, nxc, nyc, nzc),
+  divPYC (ns, nxc, nyc, nzc),
+  divPZC (ns, nxc, nyc, nzc),
   tempC  (nxc, nyc, nzc),
   tempX  (nxn, nyn, nzn),
   tempY  (nxn, nyn, nzn),
@@ -148,6 +153,9 @@ EMfields3D::EMfields3D(Collective * col, Grid * grid) :
   Bx_ext.setall(0.);
   By_ext.setall(0.);
   Bz_ext.setall(0.);
+  Jx_ext.setall(0.);
+  Jy_ext.setall(0.);
+  Jz_ext.setall(0.);
   //
   PoissonCorrection = false;
   if (col->getPoissonCorrection()=="yes") PoissonCorrection = true;
@@ -186,6 +194,13 @@ EMfields3D::EMfields3D(Collective * col, Grid * grid) :
     else
       DriftSpecies[i] = false;
   }
+  // pressures of these species are summed only for output
+  NeglectPressure = new bool[ns];
+  for (int i = 0; i < ns; i++)
+    NeglectPressure[i] = col->getNeglectPressure(i);
+  pressureOutput = true;
+  batchedVectors = new double***[10*ns];
+  divPValid = false;
   /*! parameters for GEM challenge */
   FourPI = 16 * atan(1.0);
   /*! Restart */
@@ -201,6 +216,7 @@ EMfields3D::EMfields3D(Collective * col, Grid * grid) :
   injFieldsFront  = new injInfoFields(nxn, nyn, nzn);
   injFieldsRear   = new injInfoFields(nxn, nyn, nzn);
 
+  momentTiles = 0;
   if(Parameters::get_VECTORIZE_MOMENTS())
   {
     // In this case particles are sorted
@@ -208,6 +224,19 @@ EMfields3D::EMfields3D(Collective * col, Grid * grid) :
     // to sum moments in a separate array.
     sizeMomentsArray = 1;
   }
+  else if(Parameters::get_MOMENTS_TYPE()==Parameters::AoScolored)
+  {
+    // threads sum moments directly into the moments of each species
+    sizeMomentsArray = 1;
+  }
+  else if(Parameters::get_MOMENTS_TYPE()==Parameters::AoStiled)
+  {
+    // each thread sums moments in the tiles that it is assigned
+    sizeMomentsArray = 1;
+    momentTiles = new MomentTiles(grid->getNXC(), grid->getNYC(),
+      grid->getNZC(), Parameters::get_MOMENT_TILE_SIZE(), ns,
+      Parameters::get_FLOAT_MOMENT_TILES());
+  }
   else
   {
     sizeMomentsArray = omp_get_max_threads();
@@ -231,13 +260,13 @@ void EMfields3D::sumMomentsOld(const Particles3Dcomm& pcls, Grid * grid, Virtual
   const double xstart = grid->getXstart();
   const double ystart = grid->getYstart();
   const double zstart = grid->getZstart();
-  double const*const x = pcls.getXall();
-  double const*const y = pcls.getYall();
-  double const*const z = pcls.getZall();
-  double const*const u = pcls.getUall();
-  double const*const v = pcls.getVall();
-  double const*const w = pcls.getWall();
-  double const*const q = pcls.getQall();
+  const_strided_view<double> x = pcls.getXview();
+  const_strided_view<double> y = pcls.getYview();
+  const_strided_view<double> z = pcls.getZview();
+  const_strided_view<double> u = pcls.getUview();
+  const_strided_view<double> v = pcls.getVview();
+  const_strided_view<double> w = pcls.getWview();
+  const_strided_view<double> q = pcls.getQview();
   //
   const int is = pcls.get_species_num();
 
@@ -403,17 +432,17 @@ void EMfields3D::sumMoments(const Particles3Dcomm* part, Grid * grid, VirtualTop
   for (int i = 0; i < ns; i++)
   {
     const Particles3Dcomm& pcls = part[i];
-    assert_eq(pcls.get_particleType(), ParticleType::SoA);
     const int is = pcls.get_species_num();
     assert_eq(i,is);
 
-    double const*const x = pcls.getXall();
-    double const*const y = pcls.getYall();
-    double const*const z = pcls.getZall();
-    double const*const u = pcls.getUall();
-    double const*const v = pcls.getVall();
-    double const*const w = pcls.getWall();
-    double const*const q = pcls.getQall();
+    // (reads particles in place whether they are AoS or SoA)
+    const_strided_view<double> x = pcls.getXview();
+    const_strided_view<double> y = pcls.getYview();
+    const_strided_view<double> z = pcls.getZview();
+    const_strided_view<double> u = pcls.getUview();
+    const_strided_view<double> v = pcls.getVview();
+    const_strided_view<double> w = pcls.getWview();
+    const_strided_view<double> q = pcls.getQview();
 
     const int nop = pcls.getNOP();
 
@@ -589,10 +618,6 @@ void EMfields3D::sumMoments(const Particles3Dcomm* part, Grid * grid, VirtualTop
     // communicateGhostP2G(is, 0, 0, 0, 0, vct);
   }
   }
-  for (int i = 0; i < ns; i++)
-  {
-    communicateGhostP2G(i, 0, 0, 0, 0, vct);
-  }
 }
 
 void EMfields3D::sumMoments_AoS(
@@ -622,6 +647,11 @@ void EMfields3D::sumMoments_AoS(
     assert_eq(species_idx,is);
 
     const int nop = pcls.getNOP();
+    // cells where the mover left the particles, if cached
+    const int* cells = pcls.get_pcl_cells();
+    // the pressures (moments 4-9) may be needed only for output
+    const bool with_pressure = sums_pressure(is);
+    const int num_moments = with_pressure ? 10 : 4;
 
     int thread_num = omp_get_thread_num();
     { timeTasks_begin_task(TimeTasks::MOMENT_ACCUMULATION); }
@@ -666,9 +696,19 @@ void EMfields3D::sumMoments_AoS(
       //
       // compute the weights to distribute the moments
       //
-      const int ix = 2 + int (floor((pcl.get_x() - xstart) * inv_dx));
-      const int iy = 2 + int (floor((pcl.get_y() - ystart) * inv_dy));
-      const int iz = 2 + int (floor((pcl.get_z() - zstart) * inv_dz));
+      int ix,iy,iz;
+      if(cells)
+      {
+        ix = 1 + cells[3*pidx];
+        iy = 1 + cells[3*pidx+1];
+        iz = 1 + cells[3*pidx+2];
+      }
+      else
+      {
+        ix = 2 + int (floor((pcl.get_x() - xstart) * inv_dx));
+        iy = 2 + int (floor((pcl.get_y() - ystart) * inv_dy));
+        iz = 2 + int (floor((pcl.get_z() - zstart) * inv_dz));
+      }
       const double xi0   = pcl.get_x() - grid->getXN(ix-1);
       const double eta0  = pcl.get_y() - grid->getYN(iy-1);
       const double zeta0 = pcl.get_z() - grid->getZN(iz-1);
@@ -701,6 +741,611 @@ void EMfields3D::sumMoments_AoS(
       //weights[6] = xi1 * eta1 * zeta0 * qi * invVOL; // weight110
       //weights[7] = xi1 * eta1 * zeta1 * qi * invVOL; // weight111
 
+      // add particle to moments
+      {
+        arr1_double_fetch momentsArray[8];
+        arr2_double_fetch moments00 = moments[ix  ][iy  ];
+        arr2_double_fetch moments01 = moments[ix  ][iy-1];
+        arr2_double_fetch moments10 = moments[ix-1][iy  ];
+        arr2_double_fetch moments11 = moments[ix-1][iy-1];
+        momentsArray[0] = moments00[iz  ]; // moments000 
+        momentsArray[1] = moments00[iz-1]; // moments001 
+        momentsArray[2] = moments01[iz  ]; // moments010 
+        momentsArray[3] = moments01[iz-1]; // moments011 
+        momentsArray[4] = moments10[iz  ]; // moments100 
+        momentsArray[5] = moments10[iz-1]; // moments101 
+        momentsArray[6] = moments11[iz  ]; // moments110 
+        momentsArray[7] = moments11[iz-1]; // moments111 
+
+        for(int m=0; m<num_moments; m++)
+        for(int c=0; c<8; c++)
+        {
+          momentsArray[c][m] += velmoments[m]*weights[c];
+        }
+      }
+    }
+    if(!thread_num) timeTasks_end_task(TimeTasks::MOMENT_ACCUMULATION);
+
+    // reduction
+    if(!thread_num) timeTasks_begin_task(TimeTasks::MOMENT_REDUCTION);
+
+    // reduce moments in parallel
+    //
+    for(int thread_num=0;thread_num<get_sizeMomentsArray();thread_num++)
+    {
+      arr4_double moments = fetch_moments10Array(thread_num).fetch_arr();
+      #pragma omp for collapse(2)
+      for(int i=0;i<nxn;i++)
+      for(int j=0;j<nyn;j++)
+      for(int k=0;k<nzn;k++)
+      {
+        rhons[is][i][j][k] += invVOL*moments[i][j][k][0];
+        Jxs  [is][i][j][k] += invVOL*moments[i][j][k][1];
+        Jys  [is][i][j][k] += invVOL*moments[i][j][k][2];
+        Jzs  [is][i][j][k] += invVOL*moments[i][j][k][3];
+        if(with_pressure)
+        {
+          pXXsn[is][i][j][k] += invVOL*moments[i][j][k][4];
+          pXYsn[is][i][j][k] += invVOL*moments[i][j][k][5];
+          pXZsn[is][i][j][k] += invVOL*moments[i][j][k][6];
+          pYYsn[is][i][j][k] += invVOL*moments[i][j][k][7];
+          pYZsn[is][i][j][k] += invVOL*moments[i][j][k][8];
+          pZZsn[is][i][j][k] += invVOL*moments[i][j][k][9];
+        }
+      }
+    }
+    if(!thread_num) timeTasks_end_task(TimeTasks::MOMENT_REDUCTION);
+  }
+  }
+}
+
+// add moments of the particles in a bucket (mesh cell) to the
+// 8 nodes of the cell
+//
+static inline void sum_bucket_moments(double* momentsArray[8],
+  const Particles3Dcomm& pcls, int bucket_offset, int bucket_end,
+  double xlow, double ylow, double zlow,
+  double xhgh, double yhgh, double zhgh, double invVOL)
+{
+  for (int pidx = bucket_offset; pidx < bucket_end; pidx++)
+  {
+    const SpeciesParticle& pcl = pcls.get_pcl(pidx);
+    // compute the quadratic moments of velocity
+    //
+    const double ui=pcl.get_u();
+    const double vi=pcl.get_v();
+    const double wi=pcl.get_w();
+    double velmoments[10];
+    velmoments[0] = 1.;
+    velmoments[1] = ui;
+    velmoments[2] = vi;
+    velmoments[3] = wi;
+    velmoments[4] = ui*ui;
+    velmoments[5] = ui*vi;
+    velmoments[6] = ui*wi;
+    velmoments[7] = vi*vi;
+    velmoments[8] = vi*wi;
+    velmoments[9] = wi*wi;
+
+    // compute the weights to distribute the moments
+    //
+    const double xi0   = pcl.get_x() - xlow;
+    const double eta0  = pcl.get_y() - ylow;
+    const double zeta0 = pcl.get_z() - zlow;
+    const double xi1   = xhgh - pcl.get_x();
+    const double eta1  = yhgh - pcl.get_y();
+    const double zeta1 = zhgh - pcl.get_z();
+    const double invVOLqi = invVOL*pcl.get_q();
+    const double weight0 = invVOLqi * xi0;
+    const double weight1 = invVOLqi * xi1;
+    const double weight00 = weight0*eta0;
+    const double weight01 = weight0*eta1;
+    const double weight10 = weight1*eta0;
+    const double weight11 = weight1*eta1;
+    double weights[8];
+    weights[0] = weight00*zeta0; // weight000
+    weights[1] = weight00*zeta1; // weight001
+    weights[2] = weight01*zeta0; // weight010
+    weights[3] = weight01*zeta1; // weight011
+    weights[4] = weight10*zeta0; // weight100
+    weights[5] = weight10*zeta1; // weight101
+    weights[6] = weight11*zeta0; // weight110
+    weights[7] = weight11*zeta1; // weight111
+
+    // add particle to moments
+    for(int m=0; m<10; m++)
+    for(int c=0; c<8; c++)
+    {
+      momentsArray[c][m] += velmoments[m]*weights[c];
+    }
+  }
+}
+
+// number of particles whose moments sum_bucket_moments_simd()
+// computes at once; 8 doubles fill a 512-bit vector register
+// and two 256-bit ones
+#define MOMENT_SIMD_WIDTH 8
+
+// vectorized version of previous method
+//
+// Particles are processed MOMENT_SIMD_WIDTH at a time, one per
+// vector lane.  Each lane accumulates its own 8 corners x 10
+// moments (as add_moments_for_pcl_vec() intends); the lanes are
+// summed and added to the nodes once per bucket.  Loops run over
+// lanes innermost with no dependence between iterations, so any
+// vectorizing compiler maps them onto the vector unit of the
+// target (SSE, AVX, AVX-512) without intrinsics.  The result
+// agrees with sum_bucket_moments() up to roundoff, since the
+// particles are summed in a different order; compile with
+// -DCHECK_SIMD_MOMENTS to check this for every bucket.
+//
+static inline void sum_bucket_moments_simd(double* momentsArray[8],
+  const Particles3Dcomm& pcls, int bucket_offset, int bucket_end,
+  double xlow, double ylow, double zlow,
+  double xhgh, double yhgh, double zhgh, double invVOL)
+{
+  const int W = MOMENT_SIMD_WIDTH;
+  double momentsAccVec[8][10][W];
+  memset(momentsAccVec,0,sizeof(double)*8*10*W);
+  for (int pidx = bucket_offset; pidx < bucket_end; pidx += W)
+  {
+    // gather particle data into lanes;
+    // unused lanes have zero charge and so add nothing
+    double x[W], y[W], z[W], u[W], v[W], w[W], q[W];
+    const int num_lanes = std::min(W, bucket_end - pidx);
+    for(int l=0; l<num_lanes; l++)
+    {
+      const SpeciesParticle& pcl = pcls.get_pcl(pidx+l);
+      x[l] = pcl.get_x();
+      y[l] = pcl.get_y();
+      z[l] = pcl.get_z();
+      u[l] = pcl.get_u();
+      v[l] = pcl.get_v();
+      w[l] = pcl.get_w();
+      q[l] = pcl.get_q();
+    }
+    for(int l=num_lanes; l<W; l++)
+    {
+      x[l] = xlow; y[l] = ylow; z[l] = zlow;
+      u[l] = 0.; v[l] = 0.; w[l] = 0.; q[l] = 0.;
+    }
+
+    // compute the quadratic moments of velocity
+    // and the weights to distribute the moments
+    //
+    double velmoments[10][W];
+    double weights[8][W];
+    #pragma omp simd
+    for(int l=0; l<W; l++)
+    {
+      velmoments[0][l] = 1.;
+      velmoments[1][l] = u[l];
+      velmoments[2][l] = v[l];
+      velmoments[3][l] = w[l];
+      velmoments[4][l] = u[l]*u[l];
+      velmoments[5][l] = u[l]*v[l];
+      velmoments[6][l] = u[l]*w[l];
+      velmoments[7][l] = v[l]*v[l];
+      velmoments[8][l] = v[l]*w[l];
+      velmoments[9][l] = w[l]*w[l];
+
+      const double xi0   = x[l] - xlow;
+      const double eta0  = y[l] - ylow;
+      const double zeta0 = z[l] - zlow;
+      const double xi1   = xhgh - x[l];
+      const double eta1  = yhgh - y[l];
+      const double zeta1 = zhgh - z[l];
+      const double invVOLqi = invVOL*q[l];
+      const double weight0 = invVOLqi * xi0;
+      const double weight1 = invVOLqi * xi1;
+      const double weight00 = weight0*eta0;
+      const double weight01 = weight0*eta1;
+      const double weight10 = weight1*eta0;
+      const double weight11 = weight1*eta1;
+      weights[0][l] = weight00*zeta0; // weight000
+      weights[1][l] = weight00*zeta1; // weight001
+      weights[2][l] = weight01*zeta0; // weight010
+      weights[3][l] = weight01*zeta1; // weight011
+      weights[4][l] = weight10*zeta0; // weight100
+      weights[5][l] = weight10*zeta1; // weight101
+      weights[6][l] = weight11*zeta0; // weight110
+      weights[7][l] = weight11*zeta1; // weight111
+    }
+
+    // add particles to the accumulators of their lanes
+    for(int c=0; c<8; c++)
+    for(int m=0; m<10; m++)
+    {
+      #pragma omp simd
+      for(int l=0; l<W; l++)
+        momentsAccVec[c][m][l] += velmoments[m][l]*weights[c][l];
+    }
+  }
+  #ifdef CHECK_SIMD_MOMENTS
+  // moments of the bucket summed one particle at a time
+  double momentsScalar[8][10];
+  memset(momentsScalar,0,sizeof(double)*8*10);
+  double* momentsScalarArray[8];
+  for(int c=0; c<8; c++) momentsScalarArray[c] = momentsScalar[c];
+  sum_bucket_moments(momentsScalarArray, pcls, bucket_offset, bucket_end,
+    xlow, ylow, zlow, xhgh, yhgh, zhgh, invVOL);
+  // the weights of a particle are at most its charge, so the
+  // roundoff of either sum of moments of velocity order n is
+  // bounded relative to the sum of |q|*max(|u|,|v|,|w|)^n
+  double abs_moments[3] = {0., 0., 0.};
+  for (int pidx = bucket_offset; pidx < bucket_end; pidx++)
+  {
+    const SpeciesParticle& pcl = pcls.get_pcl(pidx);
+    const double speed = std::max(fabs(pcl.get_u()),
+      std::max(fabs(pcl.get_v()), fabs(pcl.get_w())));
+    abs_moments[0] += fabs(pcl.get_q());
+    abs_moments[1] += fabs(pcl.get_q())*speed;
+    abs_moments[2] += fabs(pcl.get_q())*speed*speed;
+  }
+  const int moment_order[10] = {0, 1, 1, 1, 2, 2, 2, 2, 2, 2};
+  const double rel_tol = 4*(bucket_end - bucket_offset + W)*DBL_EPSILON;
+  #endif
+  // sum over lanes
+  for(int c=0; c<8; c++)
+  for(int m=0; m<10; m++)
+  {
+    double sum = 0.;
+    for(int l=0; l<W; l++) sum += momentsAccVec[c][m][l];
+    momentsArray[c][m] += sum;
+    #ifdef CHECK_SIMD_MOMENTS
+    assert_le(fabs(sum - momentsScalar[c][m]),
+      rel_tol*abs_moments[moment_order[m]]);
+    #endif
+  }
+}
+
+// sum moments of particles sorted by mesh cell, tile by tile
+//
+// This avoids giving each thread a copy of the moments of the
+// whole subdomain (as in sumMoments_AoS()), whose zeroing and
+// reduction cost grows with the number of threads.  Each tile
+// is summed by a single thread into a small array that stays
+// in cache; the tiles are then reduced node by node, in an
+// order that does not depend on the number of threads.
+//
+// All species are summed in a single pass over the tiles
+// and reduced in a single pass over the nodes, so the cost
+// of synchronization does not grow with the number of species.
+//
+void EMfields3D::sumMoments_tiled(
+  const Particles3Dcomm* part, Grid * grid, VirtualTopology3D * vct)
+{
+  assert1(momentTiles);
+  const int nxn = grid->getNXN();
+  const int nyn = grid->getNYN();
+  const int nzn = grid->getNZN();
+  const int num_tiles = momentTiles->get_num_tiles();
+  const int tile_nodes = momentTiles->get_tile_nodes();
+  const int node_stride = momentTiles->get_node_stride();
+  const bool simd_moments = Parameters::get_SIMD_MOMENTS();
+  const bool single_precision = momentTiles->is_single_precision();
+  for (int species_idx = 0; species_idx < ns; species_idx++)
+  {
+    assert_eq(part[species_idx].get_particleType(), ParticleType::AoS);
+    assert_eq(part[species_idx].get_species_num(), species_idx);
+  }
+  // offset in the tile of each node of a cell
+  // relative to its lower corner node
+  int corner_offset[8];
+  corner_offset[0] = ((1*tile_nodes+1)*tile_nodes+1)*node_stride; // moments000
+  corner_offset[1] = ((1*tile_nodes+1)*tile_nodes+0)*node_stride; // moments001
+  corner_offset[2] = ((1*tile_nodes+0)*tile_nodes+1)*node_stride; // moments010
+  corner_offset[3] = ((1*tile_nodes+0)*tile_nodes+0)*node_stride; // moments011
+  corner_offset[4] = ((0*tile_nodes+1)*tile_nodes+1)*node_stride; // moments100
+  corner_offset[5] = ((0*tile_nodes+1)*tile_nodes+0)*node_stride; // moments101
+  corner_offset[6] = ((0*tile_nodes+0)*tile_nodes+1)*node_stride; // moments110
+  corner_offset[7] = 0; // moments111
+  #pragma omp parallel
+  {
+    const int thread_num = omp_get_thread_num();
+    if(!thread_num) timeTasks_begin_task(TimeTasks::MOMENT_ACCUMULATION);
+    // tiles differ in the number of particles they contain
+    #pragma omp for schedule(dynamic)
+    for (int t = 0; t < num_tiles; t++)
+    {
+      double* tile = 0;
+      float* tile_float = 0;
+      const int tile_size = tile_nodes*tile_nodes*tile_nodes*node_stride;
+      if(single_precision)
+      {
+        tile_float = momentTiles->fetch_tile_float(t);
+        for(int i=0; i<tile_size; i++) tile_float[i]=0;
+      }
+      else
+      {
+        tile = momentTiles->fetch_tile(t);
+        for(int i=0; i<tile_size; i++) tile[i]=0;
+      }
+      int cbeg[3], cend[3];
+      momentTiles->get_tile_cells(t, cbeg, cend);
+      for (int cx = cbeg[0]; cx < cend[0]; cx++)
+      for (int cy = cbeg[1]; cy < cend[1]; cy++)
+      for (int cz = cbeg[2]; cz < cend[2]; cz++)
+      {
+        // a particle in cell (cx,cy,cz) lies between
+        // nodes (cx,cy,cz) and (cx+1,cy+1,cz+1)
+        const double xlow = grid->getXN(cx);
+        const double ylow = grid->getYN(cy);
+        const double zlow = grid->getZN(cz);
+        const double xhgh = grid->getXN(cx+1);
+        const double yhgh = grid->getYN(cy+1);
+        const double zhgh = grid->getZN(cz+1);
+        // lower corner node of the cell in the tile
+        const int lower_node = (((cx-cbeg[0])*tile_nodes
+          + (cy-cbeg[1]))*tile_nodes + (cz-cbeg[2]))*node_stride;
+        for (int is = 0; is < ns; is++)
+        {
+          const Particles3Dcomm& pcls = part[is];
+          // in single precision the moments of the cell
+          // are summed in double and then added to the tile
+          double momentsAcc[8][10];
+          double* momentsArray[8];
+          if(single_precision)
+          {
+            memset(momentsAcc,0,sizeof(double)*8*10);
+            for(int c=0; c<8; c++) momentsArray[c] = momentsAcc[c];
+          }
+          else
+          {
+            for(int c=0; c<8; c++)
+              momentsArray[c] = tile + lower_node + corner_offset[c] + is*10;
+          }
+
+          const int bucket_offset = pcls.get_bucket_offset(cx,cy,cz);
+          const int bucket_end
+            = bucket_offset + pcls.get_numpcls_in_bucket(cx,cy,cz);
+          if(simd_moments)
+            sum_bucket_moments_simd(momentsArray, pcls,
+              bucket_offset, bucket_end,
+              xlow, ylow, zlow, xhgh, yhgh, zhgh, invVOL);
+          else
+            sum_bucket_moments(momentsArray, pcls,
+              bucket_offset, bucket_end,
+              xlow, ylow, zlow, xhgh, yhgh, zhgh, invVOL);
+
+          if(single_precision)
+          {
+            for(int c=0; c<8; c++)
+            {
+              float* node = tile_float + lower_node + corner_offset[c] + is*10;
+              for(int m=0; m<10; m++)
+                node[m] += momentsAcc[c][m];
+            }
+          }
+        }
+      }
+    }
+    if(!thread_num) timeTasks_end_task(TimeTasks::MOMENT_ACCUMULATION);
+
+    // reduction
+    if(!thread_num) timeTasks_begin_task(TimeTasks::MOMENT_REDUCTION);
+
+    // nodes inside a tile are simply copied;
+    // nodes on faces of tiles are summed over the tiles
+    //
+    double* moments = momentTiles->fetch_node_buffer(thread_num);
+    #pragma omp for collapse(2)
+    for(int i=0;i<nxn;i++)
+    for(int j=0;j<nyn;j++)
+    for(int k=0;k<nzn;k++)
+    {
+      for(int m=0; m<node_stride; m++) moments[m] = 0.;
+      momentTiles->add_node_moments(moments, i, j, k);
+      for (int is = 0; is < ns; is++)
+      {
+        const double* moments_s = moments + is*10;
+        rhons[is][i][j][k] += invVOL*moments_s[0];
+        Jxs  [is][i][j][k] += invVOL*moments_s[1];
+        Jys  [is][i][j][k] += invVOL*moments_s[2];
+        Jzs  [is][i][j][k] += invVOL*moments_s[3];
+        pXXsn[is][i][j][k] += invVOL*moments_s[4];
+        pXYsn[is][i][j][k] += invVOL*moments_s[5];
+        pXZsn[is][i][j][k] += invVOL*moments_s[6];
+        pYYsn[is][i][j][k] += invVOL*moments_s[7];
+        pYZsn[is][i][j][k] += invVOL*moments_s[8];
+        pZZsn[is][i][j][k] += invVOL*moments_s[9];
+      }
+    }
+    if(!thread_num) timeTasks_end_task(TimeTasks::MOMENT_REDUCTION);
+  }
+}
+
+// sum moments of particles sorted by mesh cell straight into
+// the moments of each species, tile by tile
+//
+// Tiles are colored by the parity of their three tile indices.
+// Tiles of the same color share no nodes, so the tiles of one
+// color are summed concurrently directly into rhons, Jxs, ...,
+// with no per-thread or per-tile copy of the moments and no
+// reduction; memory use therefore does not depend on the number
+// of threads.  The price is a barrier after each of the 8 colors.
+//
+void EMfields3D::sumMoments_colored(
+  const Particles3Dcomm* part, Grid * grid, VirtualTopology3D * vct)
+{
+  const int tile_size = Parameters::get_MOMENT_TILE_SIZE();
+  assert_gt(tile_size, 0);
+  // number of tiles in each dimension
+  const int ntx = (nxc+tile_size-1)/tile_size;
+  const int nty = (nyc+tile_size-1)/tile_size;
+  const int ntz = (nzc+tile_size-1)/tile_size;
+  const bool simd_moments = Parameters::get_SIMD_MOMENTS();
+  for (int species_idx = 0; species_idx < ns; species_idx++)
+  {
+    assert_eq(part[species_idx].get_particleType(), ParticleType::AoS);
+    assert_eq(part[species_idx].get_species_num(), species_idx);
+  }
+  #pragma omp parallel
+  {
+    const int thread_num = omp_get_thread_num();
+    if(!thread_num) timeTasks_begin_task(TimeTasks::MOMENT_ACCUMULATION);
+    for (int color = 0; color < 8; color++)
+    {
+      // parity of the tile indices of this color
+      const int px = (color>>2)&1;
+      const int py = (color>>1)&1;
+      const int pz = color&1;
+      // tiles differ in the number of particles they contain
+      #pragma omp for collapse(3) schedule(dynamic)
+      for (int tx = px; tx < ntx; tx += 2)
+      for (int ty = py; ty < nty; ty += 2)
+      for (int tz = pz; tz < ntz; tz += 2)
+      {
+        const int cxend = std::min((tx+1)*tile_size, nxc);
+        const int cyend = std::min((ty+1)*tile_size, nyc);
+        const int czend = std::min((tz+1)*tile_size, nzc);
+        for (int cx = tx*tile_size; cx < cxend; cx++)
+        for (int cy = ty*tile_size; cy < cyend; cy++)
+        for (int cz = tz*tile_size; cz < czend; cz++)
+        {
+          // a particle in cell (cx,cy,cz) lies between
+          // nodes (cx,cy,cz) and (cx+1,cy+1,cz+1)
+          const double xlow = grid->getXN(cx);
+          const double ylow = grid->getYN(cy);
+          const double zlow = grid->getZN(cz);
+          const double xhgh = grid->getXN(cx+1);
+          const double yhgh = grid->getYN(cy+1);
+          const double zhgh = grid->getZN(cz+1);
+          for (int is = 0; is < ns; is++)
+          {
+            const Particles3Dcomm& pcls = part[is];
+            const int bucket_offset = pcls.get_bucket_offset(cx,cy,cz);
+            const int bucket_end
+              = bucket_offset + pcls.get_numpcls_in_bucket(cx,cy,cz);
+            if(bucket_offset == bucket_end) continue;
+
+            // moments of the cell, in the order
+            // moments000, moments001, ..., moments111
+            double momentsAcc[8][10];
+            memset(momentsAcc,0,sizeof(double)*8*10);
+            double* momentsArray[8];
+            for(int c=0; c<8; c++) momentsArray[c] = momentsAcc[c];
+            if(simd_moments)
+              sum_bucket_moments_simd(momentsArray, pcls,
+                bucket_offset, bucket_end,
+                xlow, ylow, zlow, xhgh, yhgh, zhgh, invVOL);
+            else
+              sum_bucket_moments(momentsArray, pcls,
+                bucket_offset, bucket_end,
+                xlow, ylow, zlow, xhgh, yhgh, zhgh, invVOL);
+
+            // add moments of the cell to its nodes
+            for(int c=0; c<8; c++)
+            {
+              const int i = (c&4) ? cx : cx+1;
+              const int j = (c&2) ? cy : cy+1;
+              const int k = (c&1) ? cz : cz+1;
+              const double* moments = momentsAcc[c];
+              rhons[is][i][j][k] += invVOL*moments[0];
+              Jxs  [is][i][j][k] += invVOL*moments[1];
+              Jys  [is][i][j][k] += invVOL*moments[2];
+              Jzs  [is][i][j][k] += invVOL*moments[3];
+              pXXsn[is][i][j][k] += invVOL*moments[4];
+              pXYsn[is][i][j][k] += invVOL*moments[5];
+              pXZsn[is][i][j][k] += invVOL*moments[6];
+              pYYsn[is][i][j][k] += invVOL*moments[7];
+              pYZsn[is][i][j][k] += invVOL*moments[8];
+              pZZsn[is][i][j][k] += invVOL*moments[9];
+            }
+          }
+        }
+      }
+    }
+    if(!thread_num) timeTasks_end_task(TimeTasks::MOMENT_ACCUMULATION);
+  }
+}
+
+// sum moments of compact particles
+//
+// Each compact particle carries its mesh cell and its
+// fractional offset within the cell, so no floor()
+// or node coordinate lookups are needed to compute the weights.
+// Since invVOL*dx*dy*dz = 1, the weight of the node
+// at the upper corner of the cell is simply q*fx*fy*fz,
+// where fx,fy,fz are the fractional offsets.
+//
+void EMfields3D::sumMoments_compact(
+  const Particles3Dcomm* part, Grid * grid, VirtualTopology3D * vct)
+{
+  const int nxn = grid->getNXN();
+  const int nyn = grid->getNYN();
+  const int nzn = grid->getNZN();
+  #pragma omp parallel
+  {
+  for (int species_idx = 0; species_idx < ns; species_idx++)
+  {
+    const Particles3Dcomm& pcls = part[species_idx];
+    assert_eq(pcls.get_particleType(), ParticleType::compact);
+    const int is = pcls.get_species_num();
+    assert_eq(species_idx,is);
+
+    const int nop = pcls.getNOP();
+
+    int thread_num = omp_get_thread_num();
+    { timeTasks_begin_task(TimeTasks::MOMENT_ACCUMULATION); }
+    Moments10& speciesMoments10 = fetch_moments10Array(thread_num);
+    arr4_double moments = speciesMoments10.fetch_arr();
+    double *moments1d = &moments[0][0][0][0];
+    int moments1dsize = moments.get_size();
+    for(int i=0; i<moments1dsize; i++) moments1d[i]=0;
+    //
+    #pragma omp barrier
+    #pragma omp for
+    for (int pidx = 0; pidx < nop; pidx++)
+    {
+      const SpeciesParticleCompact& pcl = pcls.get_cpcl(pidx);
+      // compute the quadratic moments of velocity
+      //
+      const double ui=pcl.get_u();
+      const double vi=pcl.get_v();
+      const double wi=pcl.get_w();
+      double velmoments[10];
+      velmoments[0] = 1.;
+      velmoments[1] = ui;
+      velmoments[2] = vi;
+      velmoments[3] = wi;
+      velmoments[4] = ui*ui;
+      velmoments[5] = ui*vi;
+      velmoments[6] = ui*wi;
+      velmoments[7] = vi*vi;
+      velmoments[8] = vi*wi;
+      velmoments[9] = wi*wi;
+
+      //
+      // compute the weights to distribute the moments
+      //
+      // node to the right of the cell
+      const int ix = pcl.get_cx() + 1;
+      const int iy = pcl.get_cy() + 1;
+      const int iz = pcl.get_cz() + 1;
+      const double xi0   = pcl.get_dx(0);
+      const double eta0  = pcl.get_dx(1);
+      const double zeta0 = pcl.get_dx(2);
+      const double xi1   = 1. - xi0;
+      const double eta1  = 1. - eta0;
+      const double zeta1 = 1. - zeta0;
+      const double qi = pcl.get_q();
+      const double weight0 = qi * xi0;
+      const double weight1 = qi * xi1;
+      const double weight00 = weight0*eta0;
+      const double weight01 = weight0*eta1;
+      const double weight10 = weight1*eta0;
+      const double weight11 = weight1*eta1;
+      double weights[8];
+      weights[0] = weight00*zeta0; // weight000
+      weights[1] = weight00*zeta1; // weight001
+      weights[2] = weight01*zeta0; // weight010
+      weights[3] = weight01*zeta1; // weight011
+      weights[4] = weight10*zeta0; // weight100
+      weights[5] = weight10*zeta1; // weight101
+      weights[6] = weight11*zeta0; // weight110
+      weights[7] = weight11*zeta1; // weight111
+
       // add particle to moments
       {
         arr1_double_fetch momentsArray[8];
@@ -754,10 +1399,6 @@ void EMfields3D::sumMoments_AoS(
     if(!thread_num) timeTasks_end_task(TimeTasks::MOMENT_REDUCTION);
   }
   }
-  for (int i = 0; i < ns; i++)
-  {
-    communicateGhostP2G(i, 0, 0, 0, 0, vct);
-  }
 }
 
 #ifdef __MIC__
@@ -1188,11 +1829,6 @@ void EMfields3D::sumMoments_AoS_intr(
     cell_moments_per_thr[thread_num].~array4<F64vec8>();
   }
   free(cell_moments_per_thr);
-
-  for (int i = 0; i < ns; i++)
-  {
-    communicateGhostP2G(i, 0, 0, 0, 0, vct);
-  }
 #endif // __MIC__
 }
 
@@ -1595,10 +2231,6 @@ void EMfields3D::sumMoments_vectorized(
     // communicateGhostP2G(is, 0, 0, 0, 0, vct);
   }
   }
-  for (int i = 0; i < ns; i++)
-  {
-    communicateGhostP2G(i, 0, 0, 0, 0, vct);
-  }
 }
 
 void EMfields3D::sumMoments_vectorized_AoS(
@@ -1807,10 +2439,6 @@ void EMfields3D::sumMoments_vectorized_AoS(
     // communicateGhostP2G(is, 0, 0, 0, 0, vct);
   }
   }
-  for (int i = 0; i < ns; i++)
-  {
-    communicateGhostP2G(i, 0, 0, 0, 0, vct);
-  }
 }
 
 /*! Calculate Electric field with the implicit solver: the Maxwell solver method is called here */
@@ -2147,6 +2775,40 @@ void EMfields3D::smooth(double value, arr3_double vector, int type, Grid * grid,
     }
   }
 }
+/* Interpolation smoothing of three node based vectors at once (as smooth() with type = 1 for each), with one exchange of ghost cells per sweep for all three */
+void EMfields3D::smooth(double value, arr3_double vectX, arr3_double vectY, arr3_double vectZ, Grid * grid, VirtualTopology3D * vct) {
+  if (value == 1.0)
+    return;
+  const int nx = grid->getNXN();
+  const int ny = grid->getNYN();
+  const int nz = grid->getNZN();
+  double ***vectors[3] = {vectX.fetch_arr3(), vectY.fetch_arr3(), vectZ.fetch_arr3()};
+  array3_double temp(nx, ny, nz);
+  int nvolte = 6;
+  for (int icount = 1; icount < nvolte + 1; icount++) {
+    communicateNodeBoxStencilBC_P_batched(nx, ny, nz, 3, vectors, 2, 2, 2, 2, 2, 2, vct);
+    if (icount % 2 == 1) {
+      value = 0.;
+    }
+    else {
+      value = 0.5;
+    }
+    const double alpha = (1.0 - value) / 6;
+    for (int c = 0; c < 3; c++) {
+      double ***vector = vectors[c];
+      #pragma omp parallel for collapse(2)
+      for (int i = 1; i < nx - 1; i++)
+        for (int j = 1; j < ny - 1; j++)
+          for (int k = 1; k < nz - 1; k++)
+            temp[i][j][k] = value * vector[i][j][k] + alpha * (vector[i - 1][j][k] + vector[i + 1][j][k] + vector[i][j - 1][k] + vector[i][j + 1][k] + vector[i][j][k - 1] + vector[i][j][k + 1]);
+      #pragma omp parallel for collapse(2)
+      for (int i = 1; i < nx - 1; i++)
+        for (int j = 1; j < ny - 1; j++)
+          for (int k = 1; k < nz - 1; k++)
+            vector[i][j][k] = temp[i][j][k];
+    }
+  }
+}
 /* Interpolation smoothing: Smoothing (vector must already have ghost cells) TO MAKE SMOOTH value as to be different from 1.0 type = 0 --> center based vector ; type = 1 --> node based vector ; */
 void EMfields3D::smoothE(double value, VirtualTopology3D * vct, Collective *col) {
 
@@ -2671,37 +3333,72 @@ void EMfields3D::AddPerturbation(double deltaBoB, double kx, double ky, double E
 }
 
 
+// interpolate on node (i,j,k) from central points (as Grid3DCU::interpC2N)
+static inline double interpC2N(double ***vecFieldC, int i, int j, int k) {
+  return .125 * (vecFieldC[i][j][k] + vecFieldC[i - 1][j][k] + vecFieldC[i][j - 1][k] + vecFieldC[i][j][k - 1] + vecFieldC[i - 1][j - 1][k] + vecFieldC[i - 1][j][k - 1] + vecFieldC[i][j - 1][k - 1] + vecFieldC[i - 1][j - 1][k - 1]);
+}
+
 /*! Calculate hat rho hat, Jx hat, Jy hat, Jz hat */
+//
+// The contributions of all species to J hat are computed in two
+// threaded passes: the divergence of the pressure tensors of all
+// species on centers (in communicateGhostP2G_overlapped(), which
+// must precede this), then (after a single exchange of the ghost
+// cells of all species and components) their interpolation to
+// nodes, fused with the sum with the currents and with PIdot.
+//
 void EMfields3D::calculateHatFunctions(Grid * grid, VirtualTopology3D * vct) {
+  if (!divPValid)
+    eprintf("the pressure divergences are stale:"
+      " call communicateGhostP2G_overlapped() first");
+  divPValid = false;
   // smoothing
   smooth(Smooth, rhoc, 0, grid, vct);
   // calculate j hat
 
-  for (int is = 0; is < ns; is++) {
-    grid->divSymmTensorN2C(tempXC, tempYC, tempZC, pXXsn, pXYsn, pXZsn, pYYsn, pYZsn, pZZsn, is);
-
-    scale(tempXC, -dt / 2.0, nxc, nyc, nzc);
-    scale(tempYC, -dt / 2.0, nxc, nyc, nzc);
-    scale(tempZC, -dt / 2.0, nxc, nyc, nzc);
-    // communicate before interpolating
-    communicateCenterBC_P(nxc, nyc, nzc, tempXC, 2, 2, 2, 2, 2, 2, vct);
-    communicateCenterBC_P(nxc, nyc, nzc, tempYC, 2, 2, 2, 2, 2, 2, vct);
-    communicateCenterBC_P(nxc, nyc, nzc, tempZC, 2, 2, 2, 2, 2, 2, vct);
-
-    grid->interpC2N(tempXN, tempXC);
-    grid->interpC2N(tempYN, tempYC);
-    grid->interpC2N(tempZN, tempZC);
-    sum(tempXN, Jxs, nxn, nyn, nzn, is);
-    sum(tempYN, Jys, nxn, nyn, nzn, is);
-    sum(tempZN, Jzs, nxn, nyn, nzn, is);
-    // PIDOT
-    PIdot(Jxh, Jyh, Jzh, tempXN, tempYN, tempZN, is, grid);
-
+  // communicate -dt/2 times the divergence of
+  // the pressure of each species before interpolating
+  // (species whose pressure is neglected contribute only their currents)
+  {
+    double ****vectors = batchedVectors;
+    int ncomp = 0;
+    for (int is = 0; is < ns; is++) {
+      if (NeglectPressure[is])
+        continue;
+      vectors[ncomp++] = divPXC.fetch_arr4()[is];
+      vectors[ncomp++] = divPYC.fetch_arr4()[is];
+      vectors[ncomp++] = divPZC.fetch_arr4()[is];
+    }
+    if (ncomp)
+      communicateCenterBC_P_batched(nxc, nyc, nzc, ncomp, vectors, 2, 2, 2, 2, 2, 2, vct);
   }
+
+  #pragma omp parallel for collapse(2)
+  for (int i = 1; i < nxn - 1; i++)
+    for (int j = 1; j < nyn - 1; j++)
+      for (int k = 1; k < nzn - 1; k++)
+        for (int is = 0; is < ns; is++) {
+          double vectX = Jxs[is][i][j][k];
+          double vectY = Jys[is][i][j][k];
+          double vectZ = Jzs[is][i][j][k];
+          if (!NeglectPressure[is]) {
+            vectX = interpC2N(divPXC.fetch_arr4()[is], i, j, k) + vectX;
+            vectY = interpC2N(divPYC.fetch_arr4()[is], i, j, k) + vectY;
+            vectZ = interpC2N(divPZC.fetch_arr4()[is], i, j, k) + vectZ;
+          }
+          // PIDOT
+          const double beta = .5 * qom[is] * dt / c;
+          const double omcx = beta * (Bxn[i][j][k] + Bx_ext[i][j][k]);
+          const double omcy = beta * (Byn[i][j][k] + By_ext[i][j][k]);
+          const double omcz = beta * (Bzn[i][j][k] + Bz_ext[i][j][k]);
+          const double edotb = vectX * omcx + vectY * omcy + vectZ * omcz;
+          const double denom = 1 / (1.0 + omcx * omcx + omcy * omcy + omcz * omcz);
+          Jxh[i][j][k] += (vectX + (vectY * omcz - vectZ * omcy + edotb * omcx)) * denom;
+          Jyh[i][j][k] += (vectY + (vectZ * omcx - vectX * omcz + edotb * omcy)) * denom;
+          Jzh[i][j][k] += (vectZ + (vectX * omcy - vectY * omcx + edotb * omcz)) * denom;
+        }
   // smooth j
-  smooth(Smooth, Jxh, 1, grid, vct);
-  smooth(Smooth, Jyh, 1, grid, vct);
-  smooth(Smooth, Jzh, 1, grid, vct);
+  smooth(Smooth, Jxh, Jyh, Jzh, grid, vct);
 
   // calculate rho hat = rho - (dt*theta)div(jhat)
   grid->divN2C(tempXC, Jxh, Jyh, Jzh);
@@ -2762,6 +3459,116 @@ void EMfields3D::communicateGhostP2G(int ns, int bcFaceXright, int bcFaceXleft,
   communicateNode_P(nxn, nyn, nzn, pZZsn, ns, vct);
 }
 
+// get the box [ilo,ihi)x[jlo,jhi)x[klo,khi) of a mesh less the
+// points at most width from its edge, and the six slabs that
+// make up those points (some of which may be empty)
+//
+static void get_interior_and_boundary_slabs(int interior[6], int slabs[6][6],
+  int ilo, int ihi, int jlo, int jhi, int klo, int khi, int width)
+{
+  const int iin_lo = std::min(ilo + width, ihi);
+  const int iin_hi = std::max(ihi - width, iin_lo);
+  const int jin_lo = std::min(jlo + width, jhi);
+  const int jin_hi = std::max(jhi - width, jin_lo);
+  const int kin_lo = std::min(klo + width, khi);
+  const int kin_hi = std::max(khi - width, kin_lo);
+  const int boxes[7][6] = {
+    {iin_lo, iin_hi, jin_lo, jin_hi, kin_lo, kin_hi},
+    {ilo, iin_lo, jlo, jhi, klo, khi},
+    {iin_hi, ihi, jlo, jhi, klo, khi},
+    {iin_lo, iin_hi, jlo, jin_lo, klo, khi},
+    {iin_lo, iin_hi, jin_hi, jhi, klo, khi},
+    {iin_lo, iin_hi, jin_lo, jin_hi, klo, kin_lo},
+    {iin_lo, iin_hi, jin_lo, jin_hi, kin_hi, khi}};
+  for (int d = 0; d < 6; d++) {
+    interior[d] = boxes[0][d];
+    for (int s = 0; s < 6; s++)
+      slabs[s][d] = boxes[s+1][d];
+  }
+}
+
+// communicate the ghost moments of all species,
+// overlapped with the work that does not depend on them
+//
+// This exchanges the moments of all species with one message per
+// face, edge and corner, does what sumOverSpecies() and
+// interpDensitiesN2C() do, and also computes the divergence
+// of the pressure tensors of all species used by
+// calculateHatFunctions().  Nodes at least two nodes away
+// from the boundary of the subdomain do not depend on the ghost
+// moments, so while the faces of the moments (nearly all of the
+// data) are in transit these quantities are computed on those
+// nodes and on the cells between them; the remaining boundary
+// strips are computed once the exchange is complete.
+//
+void EMfields3D::communicateGhostP2G_overlapped(Grid * grid, VirtualTopology3D * vct) {
+  double ****vectors = batchedVectors;
+  const int ncomp = get_moment_arrays(vectors);
+
+  int interiorN[6], slabsN[6][6];
+  get_interior_and_boundary_slabs(interiorN, slabsN, 0, nxn, 0, nyn, 0, nzn, 2);
+  int interiorC[6], slabsC[6][6];
+  get_interior_and_boundary_slabs(interiorC, slabsC, 1, nxc - 1, 1, nyc - 1, 1, nzc - 1, 1);
+
+  // interpolate adding common nodes among processors
+  BatchedInterpExchange exchange(nxn, nyn, nzn, ncomp, vectors, vct);
+  {
+    timeTasks_set_communicating();
+    exchange.begin();
+  }
+
+  // interior
+  sumOverSpecies(interiorN[0], interiorN[1], interiorN[2], interiorN[3], interiorN[4], interiorN[5]);
+  grid->interpN2C(rhoc, rhon, interiorC[0], interiorC[1], interiorC[2], interiorC[3], interiorC[4], interiorC[5]);
+  grid->divSymmTensorN2C(divPXC, divPYC, divPZC, pXXsn, pXYsn, pXZsn, pYYsn, pYZsn, pZZsn, ns, -dt / 2.0,
+    interiorC[0], interiorC[1], interiorC[2], interiorC[3], interiorC[4], interiorC[5], NeglectPressure);
+
+  {
+    timeTasks_set_communicating();
+    exchange.end();
+    // calculate the correct densities on the boundaries
+    for (int is = 0; is < ns; is++)
+      adjustNonPeriodicDensities(is, vct);
+    // put the correct values on ghost cells
+    communicateNode_P_batched(nxn, nyn, nzn, ncomp, vectors, vct);
+  }
+
+  // boundary strips
+  for (int s = 0; s < 6; s++)
+    sumOverSpecies(slabsN[s][0], slabsN[s][1], slabsN[s][2], slabsN[s][3], slabsN[s][4], slabsN[s][5]);
+  for (int s = 0; s < 6; s++) {
+    const int* box = slabsC[s];
+    grid->interpN2C(rhoc, rhon, box[0], box[1], box[2], box[3], box[4], box[5]);
+    grid->divSymmTensorN2C(divPXC, divPYC, divPZC, pXXsn, pXYsn, pXZsn, pYYsn, pYZsn, pZZsn, ns, -dt / 2.0,
+      box[0], box[1], box[2], box[3], box[4], box[5], NeglectPressure);
+  }
+  divPValid = true;
+}
+
+// the moments of all species, with the moments of each species together;
+// returns their number (the pressures of a species are included only
+// if they are summed this cycle, see sums_pressure())
+int EMfields3D::get_moment_arrays(double ***vectors[]) {
+  double ****moments[10] = {
+    rhons.fetch_arr4(),
+    Jxs  .fetch_arr4(),
+    Jys  .fetch_arr4(),
+    Jzs  .fetch_arr4(),
+    pXXsn.fetch_arr4(),
+    pXYsn.fetch_arr4(),
+    pXZsn.fetch_arr4(),
+    pYYsn.fetch_arr4(),
+    pYZsn.fetch_arr4(),
+    pZZsn.fetch_arr4()};
+  int ncomp = 0;
+  for (int is = 0; is < ns; is++) {
+    const int num_moments = sums_pressure(is) ? 10 : 4;
+    for (int m = 0; m < num_moments; m++)
+      vectors[ncomp++] = moments[m][is];
+  }
+  return ncomp;
+}
+
 void EMfields3D::setZeroDerivedMoments()
 {
   for (register int i = 0; i < nxn; i++)
@@ -2784,6 +3591,7 @@ void EMfields3D::setZeroDerivedMoments()
 }
 
 void EMfields3D::setZeroPrimaryMoments() {
+  divPValid = false;
 
   // set primary moments to zero
   //
@@ -2819,6 +3627,16 @@ void EMfields3D::sumOverSpecies(VirtualTopology3D * vct) {
           rhon[i][j][k] += rhons[is][i][j][k];
 }
 
+/*!SPECIES: Sum the charge density of different species on the nodes of the box [ilo,ihi)x[jlo,jhi)x[klo,khi) */
+void EMfields3D::sumOverSpecies(int ilo, int ihi, int jlo, int jhi, int klo, int khi) {
+  #pragma omp parallel for collapse(2)
+  for (int i = ilo; i < ihi; i++)
+    for (int j = jlo; j < jhi; j++)
+      for (int k = klo; k < khi; k++)
+        for (int is = 0; is < ns; is++)
+          rhon[i][j][k] += rhons[is][i][j][k];
+}
+
 /*!SPECIES: Sum current density for different species */
 void EMfields3D::sumOverSpeciesJ() {
   for (int is = 0; is < ns; is++)
@@ -4873,6 +5691,8 @@ void EMfields3D::print(void) const {
 EMfields3D::~EMfields3D() {
   delete [] qom;
   delete [] rhoINIT;
+  delete [] NeglectPressure;
+  delete [] batchedVectors;
   delete injFieldsLeft;
   delete injFieldsRight;
   delete injFieldsTop;
@@ -4881,4 +5701,5 @@ EMfields3D::~EMfields3D() {
   delete injFieldsRear;
   for(int i=0;i<sizeMomentsArray;i++) { delete moments10Array[i]; }
   delete [] moments10Array;
+  delete momentTiles;
 }
@@ -1,5 +1,8 @@
 #include "Moments.h"
 #include "Alloc.h"
+#include "asserts.h"
+#include "ompdefs.h" // for omp_get_max_threads
+#include <algorithm> // for std::min
 
 void Moments10::set_to_zero()
 {
@@ -14,3 +17,101 @@ void Moments10::set_to_zero()
   //}
 }
 
+
+MomentTiles::MomentTiles(int nxc_, int nyc_, int nzc_, int tile_size_,
+  int num_species_, bool single_precision) :
+  arr(0),
+  arr_float(0),
+  num_species(num_species_),
+  nxc(nxc_),
+  nyc(nyc_),
+  nzc(nzc_),
+  tile_size(tile_size_)
+{
+  assert_gt(tile_size, 0);
+  ntx = (nxc+tile_size-1)/tile_size;
+  nty = (nyc+tile_size-1)/tile_size;
+  ntz = (nzc+tile_size-1)/tile_size;
+  tile_nodes = tile_size+1;
+  const size_t num_values
+    = size_t(get_num_tiles())*tile_nodes*tile_nodes*tile_nodes*get_node_stride();
+  if(single_precision)
+    arr_float = AlignedAlloc(float, num_values);
+  else
+    arr = AlignedAlloc(double, num_values);
+  // one node buffer per thread, in whole cache lines
+  const int line = ALIGNMENT/sizeof(double);
+  num_node_buffers = omp_get_max_threads();
+  node_buffer_stride = (get_node_stride()+line-1)/line*line;
+  node_buffers = AlignedAlloc(double, num_node_buffers*node_buffer_stride);
+}
+
+MomentTiles::~MomentTiles()
+{
+  AlignedFree(arr);
+  AlignedFree(arr_float);
+  AlignedFree(node_buffers);
+}
+
+void MomentTiles::get_tile_cells(int t, int cbeg[3], int cend[3])const
+{
+  const int tz = t%ntz;
+  const int ty = (t/ntz)%nty;
+  const int tx = t/(ntz*nty);
+  cbeg[0] = tx*tile_size; cend[0] = std::min(cbeg[0]+tile_size, nxc);
+  cbeg[1] = ty*tile_size; cend[1] = std::min(cbeg[1]+tile_size, nyc);
+  cbeg[2] = tz*tile_size; cend[2] = std::min(cbeg[2]+tile_size, nzc);
+}
+
+// a tile with cells [cbeg,cend) has nodes [cbeg,cend],
+// so a node can lie on the upper face of one tile and on the
+// lower face of the next.
+//
+int MomentTiles::get_node_tiles(int n, int nc, int tile[2], int local[2])const
+{
+  int count = 0;
+  if(n>0 && (n%tile_size==0 || n==nc))
+  {
+    tile[count] = (n-1)/tile_size;
+    local[count] = n-tile[count]*tile_size;
+    count++;
+  }
+  if(n<nc)
+  {
+    tile[count] = n/tile_size;
+    local[count] = n%tile_size;
+    count++;
+  }
+  return count;
+}
+
+void MomentTiles::add_node_moments(double* sum, int i, int j, int k)
+{
+  int xtile[2], xlocal[2];
+  int ytile[2], ylocal[2];
+  int ztile[2], zlocal[2];
+  const int nx = get_node_tiles(i, nxc, xtile, xlocal);
+  const int ny = get_node_tiles(j, nyc, ytile, ylocal);
+  const int nz = get_node_tiles(k, nzc, ztile, zlocal);
+  const int node_stride = get_node_stride();
+  for(int a=0; a<nx; a++)
+  for(int b=0; b<ny; b++)
+  for(int c=0; c<nz; c++)
+  {
+    const int t = (xtile[a]*nty + ytile[b])*ntz + ztile[c];
+    const size_t node_offset
+      = ((xlocal[a]*tile_nodes + ylocal[b])*tile_nodes + zlocal[c])*node_stride;
+    if(arr_float)
+    {
+      const float* node = fetch_tile_float(t) + node_offset;
+      for(int m=0; m<node_stride; m++)
+        sum[m] += node[m];
+    }
+    else
+    {
+      const double* node = fetch_tile(t) + node_offset;
+      for(int m=0; m<node_stride; m++)
+        sum[m] += node[m];
+    }
+  }
+}
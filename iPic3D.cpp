@@ -17,7 +17,7 @@ int main(int argc, char **argv) {
   KCode.Init(argc, argv);
 
   timeTasks.resetCycle();
-  KCode.CalculateMoments();
+  KCode.CalculateMoments(KCode.FirstCycle() - 1);
   for (int i = KCode.FirstCycle(); i < KCode.LastCycle(); i++) {
 
     if (KCode.get_myrank() == 0) cout << " ======= Cycle " << i << " ======= " << endl;
@@ -26,8 +26,9 @@ int main(int argc, char **argv) {
       timeTasks.resetCycle();
       KCode.CalculateField();
       b_err = KCode.ParticlesMover();
+      KCode.ResampleParticles(i);
       KCode.CalculateB();
-      KCode.CalculateMoments();
+      KCode.CalculateMoments(i);
 
       // print out total time for all tasks
       timeTasks.print_cycle_times(i);
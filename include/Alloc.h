@@ -1,7 +1,11 @@
 #ifndef IPIC_ALLOC_H
 #define IPIC_ALLOC_H
 #include <cstddef> // for alignment stuff
+#include <cstring> // for memcpy, memset
+#include <cstdlib> // for posix_memalign, free
 #include "asserts.h" // for assert_le, assert_lt
+#include "errors.h" // for eprintf
+#include "ompdefs.h" // for first_touch
 #include "arraysfwd.h"
 #include "openacc.h"
 //#include "arrays.h" // fixed-dimension arrays
@@ -24,6 +28,8 @@
       even for arr[i][j][k] notation.
     -DCHAINED_ARRAYS: use hierarchy of pointers to dereference
       even for arr.get(i,j,k) notation.
+    -DHUGE_PAGES: advise the kernel to back large arrays
+      with transparent huge pages (Linux only).
 
     By default, chained pointers are used for arr[i][j][k]
     notation (unless -DCHECK_BOUNDS is turned on, in which case
@@ -72,18 +78,164 @@
         (T *const __restrict__)(_mm_malloc(sizeof(T)*NUM, ALIGNMENT))
     #define AlignedFree(S) (_mm_free(S))
 #else
+    // As with _mm_malloc, elements are not constructed,
+    // so arrays must be of types without indirection.
+    //
+    // (With new T[NUM], gcc aligned arrays only to 16 bytes,
+    // so that the 64-byte elements of particle lists and
+    // fieldForPcls straddled cache lines.)
+    template <class type>
+    inline type* aligned_alloc_array(size_t num)
+    {
+      void* ptr = 0;
+      if(posix_memalign(&ptr, ALIGNMENT, sizeof(type)*num))
+      {
+        eprintf("posix_memalign failed to allocate %lu bytes",
+          (unsigned long)(sizeof(type)*num));
+      }
+      return (type*) ptr;
+    }
+    // the name free() is taken by the array classes
+    inline void aligned_free_array(void* ptr){ std::free(ptr); }
+    #define AlignedAlloc(T, NUM) (aligned_alloc_array<T>(NUM))
+    #define AlignedFree(S) (aligned_free_array(S))
+  #ifdef __GNUC__ // gcc and clang
+    // X need not be an lvalue (as with __assume_aligned);
+    // where it is, assume_aligned_ptr() is more reliable.
+    #define ALLOC_ALIGNED __attribute__((aligned(ALIGNMENT)))
+    #define ASSUME_ALIGNED(X) \
+      (((size_t)(X))%ALIGNMENT ? __builtin_unreachable() : (void)0)
+    #define ALIGNED(X) ASSUME_ALIGNED(X)
+  #else
     #define ALLOC_ALIGNED
     #define ASSUME_ALIGNED(X)
     #define ALIGNED(X)
-    #define AlignedFree(S) (delete[] S)
-    #define AlignedAlloc(T, NUM) (new T[NUM]) 
+  #endif
 #endif
+// returns ptr, which the compiler may assume to be aligned
+template <class type>
+inline type* assume_aligned_ptr(type* ptr)
+{
+  #if defined(__INTEL_COMPILER)
+    __assume_aligned(ptr, ALIGNMENT);
+    return ptr;
+  #elif defined(__GNUC__)
+    return (type*) __builtin_assume_aligned(ptr, ALIGNMENT);
+  #else
+    return ptr;
+  #endif
+}
 inline bool is_aligned(void *p, int N)
 {
     return (unsigned long)p % N == 0;
 }
 #define assert_aligned(X, N) assert(is_aligned(X, N));
 
+#ifdef __linux__
+  #include <sys/mman.h> // for madvise, mmap, mremap
+  #define HAVE_MREMAP
+#endif
+// advise the kernel to back a large array with huge pages
+// (reducing TLB misses when streaming particles and fields)
+inline void advise_huge_pages(void* ptr, size_t num_bytes)
+{
+  #if defined(HUGE_PAGES) && defined(__linux__) && defined(MADV_HUGEPAGE)
+    const size_t huge_page_size = size_t(1)<<21;
+    if(num_bytes < huge_page_size) return;
+    // madvise requires a range of whole pages
+    const size_t page_size = 4096;
+    const size_t beg = ((size_t)ptr + page_size-1) & ~(page_size-1);
+    const size_t end = ((size_t)ptr + num_bytes) & ~(page_size-1);
+    if(end > beg) madvise((void*)beg, end-beg, MADV_HUGEPAGE);
+  #endif
+}
+
+// NUMA placement of newly allocated arrays
+//
+// A page of memory is placed on the NUMA node (socket) of the
+// thread that first writes to it.  If one thread initializes a
+// large array then the whole array lands on its socket, and
+// threads on the other sockets must stream their part of it
+// remotely.  first_touch() zeroes a newly allocated array, each
+// thread zeroing its share under the same static partition that
+// "omp for schedule(static)" loops over the array use.
+//
+// It is applied when the field arrays and the particle lists are
+// first allocated, not when a list grows.  The array is always
+// zeroed; only arrays that are large and allocated outside a
+// parallel region are zeroed in parallel.
+//
+#define FIRST_TOUCH_MIN_BYTES (size_t(1)<<16)
+inline void first_touch(void* dst, size_t num_bytes)
+{
+  advise_huge_pages(dst, num_bytes);
+  char* out = (char*) dst;
+  #ifdef _OPENMP
+  if(num_bytes >= FIRST_TOUCH_MIN_BYTES && !omp_in_parallel())
+  {
+    #pragma omp parallel
+    {
+      const size_t nthreads = omp_get_num_threads();
+      const size_t tid = omp_get_thread_num();
+      const size_t beg = num_bytes*tid/nthreads;
+      const size_t end = num_bytes*(tid+1)/nthreads;
+      memset(out+beg, 0, end-beg);
+    }
+    return;
+  }
+  #endif
+  memset(out, 0, num_bytes);
+}
+
+// Large lists (e.g. of particles) are mapped directly from the
+// kernel so that they can grow by remapping their pages with
+// mremap() rather than by allocating, copying, and freeing.
+// Whether a list is mapped is determined by its size in bytes.
+//
+#define MAPPED_ALLOC_MIN_BYTES (size_t(1)<<22)
+inline bool is_mapped_alloc(size_t num_bytes)
+{
+  #ifdef HAVE_MREMAP
+    return num_bytes >= MAPPED_ALLOC_MIN_BYTES;
+  #else
+    return false;
+  #endif
+}
+#ifdef HAVE_MREMAP
+// mapped regions consist of whole pages
+// (and so are aligned to more than ALIGNMENT)
+inline size_t mapped_bytes(size_t num_bytes)
+{
+  const size_t page_size = 4096;
+  return (num_bytes + page_size-1) & ~(page_size-1);
+}
+inline void* mapped_alloc(size_t num_bytes)
+{
+  void* ptr = mmap(0, mapped_bytes(num_bytes), PROT_READ|PROT_WRITE,
+    MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+  if(ptr==MAP_FAILED)
+  {
+    eprintf("mmap failed to allocate %lu bytes", (unsigned long)num_bytes);
+  }
+  return ptr;
+}
+inline void* mapped_realloc(void* ptr, size_t old_bytes, size_t new_bytes)
+{
+  void* new_ptr = mremap(ptr, mapped_bytes(old_bytes),
+    mapped_bytes(new_bytes), MREMAP_MAYMOVE);
+  if(new_ptr==MAP_FAILED)
+  {
+    eprintf("mremap failed to resize %lu to %lu bytes",
+      (unsigned long)old_bytes, (unsigned long)new_bytes);
+  }
+  return new_ptr;
+}
+inline void mapped_free(void* ptr, size_t num_bytes)
+{
+  munmap(ptr, mapped_bytes(num_bytes));
+}
+#endif
+
 
 // Compile with -DCHECK_BOUNDS to turn on bounds checking.
 //#define CHECK_BOUNDS
@@ -103,6 +255,7 @@ template < class type >
 inline type * newArray1(size_t sz1)
 {
   type *arr = AlignedAlloc(type, sz1); // new type [sz1];
+  first_touch(arr, sizeof(type)*sz1);
   #pragma acc enter data create(arr[0:sz1])
   return arr;
 }
@@ -267,7 +420,8 @@ namespace iPic3D
       type* const __restrict__ arr;
     public:
       const type* get_arr()const{return arr;}
-      base_arr(size_t s) : size(s), arr(AlignedAlloc(type, s)) {}
+      base_arr(size_t s) : size(s), arr(AlignedAlloc(type, s))
+      { first_touch(arr, sizeof(type)*s); }
       base_arr(type* in, size_t s) : size(s), arr(in) {}
       ~base_arr(){}
       int get_size() { return size; }
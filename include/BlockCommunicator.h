@@ -6,7 +6,9 @@
 #include "aligned_vector.h"
 #include "MPIdata.h"
 #include "Parameters.h"
+#include "ipicmath.h" // for pow2roundup
 #include <list>
+#include <algorithm> // for std::min, std::max
 #include <mpi.h> // is there a way to forward declare mpi types?
 
 // The combination of group (comm), tag, and neighbor
@@ -105,9 +107,15 @@ class Connection
   }
 };
 
+// If true, every message carries an extra trailing element
+// that holds its signal (the finished flag and the insert flag).
+// This allows the sender to use blocks smaller than those of
+// the receiver and to deepen the ring of blocks when sends
+// have not completed, in which case it asks the receiver to
+// do likewise.  Otherwise a short message signals the end.
 inline bool signal_hack()
 {
-  return false;
+  return Parameters::get_ADAPTIVE_BLOCKS();
 }
 
 // block of elements
@@ -121,6 +129,9 @@ struct Block
   int listID;
   // used for MPI communication
   MPI_Request request;
+  // persistent receive request (and the buffer it was created for)
+  MPI_Request persistent_request;
+  const type* persistent_buf;
   // hack to piggy-back information onto message
   int signal; // char
  private: // initialized at compile time
@@ -128,23 +139,29 @@ struct Block
   static const int NUMBERS_PER_ELEMENT = sizeof(type)/sizeof(double);
  public:
   int get_capacity()const{return capacity;}
+  // used by the sender to resize a block that is not in use
+  void set_capacity(int capacity_)
+  {
+    assert(is_inactive());
+    capacity = capacity_;
+    block.reserve(capacity+1);
+  }
  public:
   Block(int capacity_, int id_):
     capacity(capacity_),
     listID(id_),
     request(MPI_REQUEST_NULL),
+    persistent_request(MPI_REQUEST_NULL),
+    persistent_buf(0),
     signal(0)
   {
     block.reserve(capacity);
   }
-  // cancel any pending communication 
   ~Block()
   {
-    if(request!=MPI_REQUEST_NULL)
-    {
-      MPI_Cancel(&request);
-      MPI_Request_free(&request);
-    }
+    cancel_comm();
+    if(persistent_request!=MPI_REQUEST_NULL)
+      MPI_Request_free(&persistent_request);
   }
  public: // accessors
   MPI_Request& fetch_request(){return request;}
@@ -172,6 +189,9 @@ struct Block
     MPI_Test(&request, &flag, &status);
     if(!flag)
       return false;
+    // a completed persistent request is inactive but not freed
+    if(request==persistent_request)
+      request = MPI_REQUEST_NULL;
     // MPI_Test man page says this should now be true
     assert(request==MPI_REQUEST_NULL);
     return true;
@@ -181,6 +201,22 @@ struct Block
     MPI_Status status;
     return test_comm(status);
   }
+  // cancel any pending communication
+  // (a persistent request is completed rather than freed,
+  // since it is kept for reuse)
+  void cancel_comm()
+  {
+    if(request==MPI_REQUEST_NULL)
+      return;
+    MPI_Cancel(&request);
+    if(request==persistent_request)
+    {
+      MPI_Wait(&request, MPI_STATUS_IGNORE);
+      request = MPI_REQUEST_NULL;
+    }
+    else
+      MPI_Request_free(&request);
+  }
 
  // sending
  //
@@ -264,8 +300,19 @@ struct Block
     // make sure that space exists to receive
     int newsize = signal_hack() ? capacity+1 : capacity;
     block.resize(newsize);
-    MPI_Irecv(&block[0], NUMBERS_PER_ELEMENT*block.size(), MPI_DOUBLE,
-      source.rank(), source.tag(), source.comm(), &request);
+    // the same receive is posted for every message on this
+    // block, so use a persistent request (which must be
+    // recreated if the buffer has moved)
+    if(persistent_buf != &block[0])
+    {
+      if(persistent_request!=MPI_REQUEST_NULL)
+        MPI_Request_free(&persistent_request);
+      MPI_Recv_init(&block[0], NUMBERS_PER_ELEMENT*block.size(), MPI_DOUBLE,
+        source.rank(), source.tag(), source.comm(), &persistent_request);
+      persistent_buf = &block[0];
+    }
+    MPI_Start(&persistent_request);
+    request = persistent_request;
   }
   // processing received data
   //
@@ -313,6 +360,7 @@ struct Block
   {
     MPI_Status status;
     MPI_Wait(&request, &status);
+    request = MPI_REQUEST_NULL;
     shrink_received_block(status);
   }
   // returns true if message has been received.
@@ -325,8 +373,8 @@ struct Block
 // process, it might be better to transfer data with a simple
 // list.
 //
-// The implementation should probably be changed to use
-// persistent requests.  My analysis of the decision 
+// Receives use persistent requests.  Sends cannot, since the
+// size of the messages varies.  My analysis of the decision 
 // regarding message size is as follows:
 //
 //   Communication time is a linear combination of total data
@@ -353,6 +401,15 @@ struct Block
 //   This determines a window of message sizes appropriate
 //   for persistent communication.
 //
+// The sender therefore adapts the size of its blocks to the
+// traffic on its connection, up to the capacity of the blocks
+// of the receiver: it uses blocks large enough that a stream of
+// the size recently sent would span the ring of blocks, so that
+// it does not have to wait for sends to complete, but no larger,
+// so that sends begin early.  Light traffic (e.g. of heavy ions)
+// thus goes out in small blocks and heavy traffic (e.g. of
+// electrons) in large blocks.
+//
 template <class type>
 class BlockCommunicator
 {
@@ -370,7 +427,17 @@ class BlockCommunicator
   //std::list<Block<type>*>::iterator curr_block;
   //std::list<Block<type>*> blockList;
   Connection connection;
+  // capacity of blocks for receiving (and maximum for sending)
   int blocksize;
+  // capacity of blocks for sending
+  int send_blocksize;
+  // number of blocks in the ring
+  int numblocks;
+  // number of elements sent in the current stream
+  // (i.e. since the last call to send_complete())
+  int stream_size;
+  // recent peak of stream_size
+  int traffic;
   // for generating the ID of the block as a list element
   int nextListID;
   // for generating the ID of the block as a message
@@ -381,6 +448,10 @@ class BlockCommunicator
   BlockCommunicator():
     connection(),
     blocksize(0),
+    send_blocksize(0),
+    numblocks(0),
+    stream_size(0),
+    traffic(0),
     nextListID(0),
     nextCommID(0),
     commState(NONE)
@@ -475,10 +546,11 @@ class BlockCommunicator
   // buffer.  So when the sender adds more blocks, it can signal
   // the receiver to do likewise.
   //
-  void insert_more_recv_blocks(int numblocks=1)
+  void insert_more_recv_blocks(int num_new_blocks=1)
   {
-    for(int i=0;i<numblocks;i++)
+    for(int i=0;i<num_new_blocks;i++)
     {
+      numblocks++;
       Block<type>* newBlock = new Block<type>(blocksize, nextListID++);
       blockList.insert(curr_block, newBlock);
       newBlock->recv_block(connection);
@@ -508,7 +580,7 @@ class BlockCommunicator
       {
         // insert another block to receive particles
         // prior to the block that we just received
-        dprintf("****** as requested, I am inserting a block ******");
+        //dprintf("****** as requested, I am inserting a block ******");
         insert_more_recv_blocks();
       }
     }
@@ -531,19 +603,12 @@ class BlockCommunicator
     assert(fetch_curr_block().is_active());
   }
 
-  // cancel and free any open receive requests
+  // cancel any open receive requests
   void cancel_recvs()
   {
     std::list<void*>::iterator b;
     for(b=blockList.begin(); b!=blockList.end();b++)
-    {
-      MPI_Request& pending_request = fetch_curr_block().fetch_request();
-      if(pending_request!=MPI_REQUEST_NULL)
-      {
-        MPI_Cancel(&pending_request);
-        MPI_Request_free(&pending_request);
-      }
-    }
+      fetch_block(b).cancel_comm();
   }
 
   MPI_Request get_curr_request()
@@ -602,6 +667,7 @@ class BlockCommunicator
     //assert_le(fetch_curr_block.size(), fetch_curr_block().get_capacity());
     // append the particle to the block.
     fetch_curr_block().fast_push_back(in);
+    stream_size++;
     //dprintf("sending particle %d in direction %d.%s",
     //  int(in.get_t()),connection.rank(), connection.tag_name());
 
@@ -628,11 +694,12 @@ class BlockCommunicator
         // if next block is still sending, insert another block to
         // use instead as next_block
         //
-        Block<type>* newBlock = new Block<type>(blocksize, nextListID++);
+        Block<type>* newBlock = new Block<type>(send_blocksize, nextListID++);
         blockList.insert(curr_block,newBlock);
+        numblocks++;
         curr_block--;
         assert(*curr_block == newBlock);
-        dprintf("inserted new block %d",nextListID-1);
+        //dprintf("inserted new block %d",nextListID-1);
 
         // hack: set flag in currblock to tell receiver
         // to insert another block for receiving
@@ -652,6 +719,8 @@ class BlockCommunicator
     fetch_curr_block().clear();
     assert(!fetch_curr_block().is_active());
     assert(fetch_curr_block().test_comm());
+    if(fetch_curr_block().get_capacity()!=send_blocksize)
+      fetch_curr_block().set_capacity(send_blocksize);
     commState=INITIAL;
   }
   // send the remaining particles, sending an empty message if
@@ -662,19 +731,38 @@ class BlockCommunicator
   {
     assert(!fetch_curr_block().isfull());
     fetch_curr_block().set_finished_flag();
+    adapt_send_blocksize();
     send_curr_block();
   }
+ private:
+  // choose the size of the blocks of the next stream
+  // from the sizes of recent streams
+  void adapt_send_blocksize()
+  {
+    if(!signal_hack()) return;
+    // let the peak decay slowly, since streams alternate between
+    // emigrants of a mover (large) and resent particles (small)
+    traffic = std::max(stream_size, traffic-traffic/8);
+    stream_size = 0;
+    const int needed = (traffic-1)/numblocks+1;
+    send_blocksize = std::min(blocksize,
+      std::max(Parameters::get_minBlockSize(), pow2roundup(needed)));
+  }
 };
 
 // === code above this point could go in something like BlockCommunicatorFwd.h ===
 #include "Parameters.h"
 
 template <typename type>
-void BlockCommunicator<type>::init(Connection connection_, int blocksize_, int numblocks)
+void BlockCommunicator<type>::init(Connection connection_, int blocksize_, int numblocks_)
 {
   assert(commState==NONE);
   connection = connection_;
   blocksize = blocksize_;
+  send_blocksize = blocksize_;
+  numblocks = numblocks_;
+  stream_size = 0;
+  traffic = 0;
   commState = INITIAL;
   nextCommID = 0;
 
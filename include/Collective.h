@@ -128,6 +128,8 @@ class Collective
     bool getVerbose()const{ return (verbose); }
     bool getTrackParticleID(int nspecies)const
       { return (TrackParticleID[nspecies]); }
+    bool getNeglectPressure(int nspecies)const
+      { return (NeglectPressure[nspecies]); }
     int getRestart_status()const{ return (restart_status); }
     string getSaveDirName()const{ return (SaveDirName); }
     string getRestartDirName()const{ return (RestartDirName); }
@@ -258,6 +260,8 @@ class Collective
 
     /*! TrackParticleID */
     bool *TrackParticleID;
+    /*! species whose pressure is left out of the implicit moments */
+    bool *NeglectPressure;
     /*! SaveDirName */
     string SaveDirName;
     /*! RestartDirName */
@@ -19,6 +19,10 @@ void communicateGhostFace(int b_len, int myrank, int right_neighbor, int left_ne
 /** communicate ghost along a direction **/
 void communicateGhostFace(int b_len, int myrank, int right_neighbor, int left_neighbor, int DIR, int XLEN, int YLEN, int ZLEN, double *ghostRightFace, double *ghostLeftFace);
 
+/** nonblocking communicateGhostFace(): post the exchange of the two faces **/
+void startGhostFace(int b_len, int right_neighbor, int left_neighbor, int DIR, int XLEN, int YLEN, int ZLEN, double *ghostRightFace, double *ghostLeftFace, double *recvRightFace, double *recvLeftFace, MPI_Request *requests);
+/** complete the exchange of startGhostFace() **/
+void finishGhostFace(int b_len, int right_neighbor, int left_neighbor, int DIR, int XLEN, int YLEN, int ZLEN, double *ghostRightFace, double *ghostLeftFace, double *recvRightFace, double *recvLeftFace, MPI_Request *requests);
 /** communicate ghost edge along a direction; there are 6 Diagonal directions through which we exchange Ghost Edges :
   0 = from   XrightYrightZsame to YleftZleftZsame; we exchange Z edge
   1 = from   XrightYleftZsame to XleftYrightZsame; we exchange Z edge
@@ -15,4 +15,34 @@ developers           : Stefano Markidis, Giovanni Lapenta
 /** communicate ghost cells and sum the contribution with a index indicating the number of species*/
 void communicateInterp(int nx, int ny, int nz, int ns, double ****vector, int bcFaceXright, int bcFaceXleft, int bcFaceYright, int bcFaceYleft, int bcFaceZright, int bcFaceZleft, VirtualTopology3D * vct);
 
+/** communicate ghost cells and sum the contributions of ncomp node arrays at once */
+void communicateInterp_batched(int nx, int ny, int nz, int ncomp, double ***const *vectors, VirtualTopology3D * vct);
+
+/** nonblocking communicateInterp_batched()
+
+    begin() posts the exchange of the ghost faces, which carry nearly
+    all of the data, and end() completes it and then exchanges and
+    sums edges and corners.  Between the two calls the arrays may be
+    read but not modified, and nodes at least two nodes away from
+    the boundary of the subdomain are final, so work on the interior
+    of the subdomain can proceed while the faces are in transit.
+    Both calls must be made by the master thread. */
+class BatchedInterpExchange
+{
+  int nx, ny, nz, ncomp;
+  double ***const *vectors;
+  VirtualTopology3D * vct;
+  double *ghostXrightFace, *ghostXleftFace;
+  double *ghostYrightFace, *ghostYleftFace;
+  double *ghostZrightFace, *ghostZleftFace;
+  double *recvXrightFace, *recvXleftFace;
+  double *recvYrightFace, *recvYleftFace;
+  double *recvZrightFace, *recvZleftFace;
+  MPI_Request requests[3][4];
+ public:
+  BatchedInterpExchange(int nx, int ny, int nz, int ncomp, double ***const *vectors, VirtualTopology3D * vct);
+  ~BatchedInterpExchange();
+  void begin();
+  void end();
+};
 #endif
@@ -32,6 +32,9 @@ void communicateNode(int nx, int ny, int nz, arr4_double vector, int ns, Virtual
 /** SPECIES: communicate ghost cells */
 void communicateNode_P(int nx, int ny, int nz, arr4_double vector, int ns, VirtualTopology3D * vct);
 
+/** communicate ghost cells of ncomp node arrays at once */
+void communicateNode_P_batched(int nx, int ny, int nz, int ncomp, double ***const *vectors, VirtualTopology3D * vct);
+
 // 
 /** communicate ghost cells (FOR CENTERS) */
 void communicateCenter(int nx, int ny, int nz, arr3_double vector, VirtualTopology3D * vct);
@@ -49,6 +52,9 @@ void communicateNodeBoxStencilBC(int nx, int ny, int nz, arr3_double vector, int
 
 void communicateNodeBoxStencilBC_P(int nx, int ny, int nz, arr3_double vector, int bcFaceXright, int bcFaceXleft, int bcFaceYright, int bcFaceYleft, int bcFaceZright, int bcFaceZleft, VirtualTopology3D * vct);
 
+/** communicate ghost faces of ncomp node arrays at once with BOX stencil */
+void communicateNodeBoxStencilBC_P_batched(int nx, int ny, int nz, int ncomp, double ***const *vectors, int bcFaceXright, int bcFaceXleft, int bcFaceYright, int bcFaceYleft, int bcFaceZright, int bcFaceZleft, VirtualTopology3D * vct);
+
 /** SPECIES: communicate ghost cells */
 void communicateCenter(int nx, int ny, int nz, arr4_double vector, int ns, VirtualTopology3D * vct);
 
@@ -58,4 +64,7 @@ void communicateCenterBC(int nx, int ny, int nz, arr3_double vector, int bcFaceX
 // /////////// communication + BC ////////////////////////////
 void communicateCenterBC_P(int nx, int ny, int nz, arr3_double vector, int bcFaceXright, int bcFaceXleft, int bcFaceYright, int bcFaceYleft, int bcFaceZright, int bcFaceZleft, VirtualTopology3D * vct);
 
+/** communicate ghost cells of ncomp center arrays at once */
+void communicateCenterBC_P_batched(int nx, int ny, int nz, int ncomp, double ***const *vectors, int bcFaceXright, int bcFaceXleft, int bcFaceYright, int bcFaceYleft, int bcFaceZright, int bcFaceZleft, VirtualTopology3D * vct);
+
 #endif
@@ -136,4 +136,54 @@ void addCorner(int nx, int ny, int nz, double ***vector, double *ghostXrightYrig
 /** add ghost cells values Corners in the 3D physical vector */
 void addCorner(int nx, int ny, int nz, double ****vector, int ns, double *ghostXrightYrightZrightCorner, double *ghostXleftYrightZrightCorner, double *ghostXrightYleftZrightCorner, double *ghostXleftYleftZrightCorner, double *ghostXrightYrightZleftCorner, double *ghostXleftYrightZleftCorner, double *ghostXrightYleftZleftCorner, double *ghostXleftYleftZleftCorner, VirtualTopology3D * vct);
 
+// BATCHED
+//
+// variants that operate on a list of ncomp node arrays at once;
+// buffers hold the ncomp values of each ghost node contiguously
+//
+/** BATCHED: prepare faces of nodes layer and n-1-layer for communication */
+void makeFace_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, int layer, double *ghostXrightFace, double *ghostXleftFace, double *ghostYrightFace, double *ghostYleftFace, double *ghostZrightFace, double *ghostZleftFace);
+
+/** BATCHED: insert the ghost cells faces in the node arrays */
+void parseFace_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXrightFace, double *ghostXleftFace, double *ghostYrightFace, double *ghostYleftFace, double *ghostZrightFace, double *ghostZleftFace);
+
+/** BATCHED: add the values of ghost cells faces to the node arrays */
+void addFace_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXrightFace, double *ghostXleftFace, double *ghostYrightFace, double *ghostYleftFace, double *ghostZrightFace, double *ghostZleftFace, VirtualTopology3D * vct);
+
+/** BATCHED: prepare ghost cell Edge Z for communication: these are communicated in Y direction */
+void makeNodeEdgeZ_batched(int nx, int ny, int nz, int ncomp, double *faceXleft, double *faceXright, double *ghostXrightYrightZsameEdge, double *ghostXleftYleftZsameEdge, double *ghostXrightYleftZsameEdge, double *ghostXleftYrightZsameEdge);
+
+/** BATCHED: prepare ghost cell Edge Y for communication: these are communicated in X direction */
+void makeNodeEdgeY_batched(int nx, int ny, int nz, int ncomp, double *faceZleft, double *faceZright, double *ghostXrightYsameZrightEdge, double *ghostXleftYsameZleftEdge, double *ghostXleftYsameZrightEdge, double *ghostXrightYsameZleftEdge);
+
+/** BATCHED: prepare ghost cell Edge X for communication: these are communicated in Z direction */
+void makeNodeEdgeX_batched(int nx, int ny, int nz, int ncomp, double *faceYleft, double *faceYright, double *ghostXsameYrightZrightEdge, double *ghostXsameYleftZleftEdge, double *ghostXsameYleftZrightEdge, double *ghostXsameYrightZleftEdge);
+
+/** BATCHED: prepare ghost cell corners for communication */
+void makeNodeCorner_batched(int nx, int ny, int nz, int ncomp, double *ghostXsameYrightZrightEdge, double *ghostXsameYleftZleftEdge, double *ghostXsameYleftZrightEdge, double *ghostXsameYrightZleftEdge, double *ghostXrightYrightZrightCorner, double *ghostXleftYrightZrightCorner, double *ghostXrightYleftZrightCorner, double *ghostXleftYleftZrightCorner, double *ghostXrightYrightZleftCorner, double *ghostXleftYrightZleftCorner, double *ghostXrightYleftZleftCorner, double *ghostXleftYleftZleftCorner);
+
+/** BATCHED: insert the ghost cells Edge Z in the node arrays */
+void parseEdgeZ_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXrightYrightZsameEdge, double *ghostXleftYleftZsameEdge, double *ghostXrightYleftZsameEdge, double *ghostXleftYrightZsameEdge);
+
+/** BATCHED: insert the ghost cells Edge Y in the node arrays */
+void parseEdgeY_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXrightYsameZrightEdge, double *ghostXleftYsameZleftEdge, double *ghostXleftYsameZrightEdge, double *ghostXrightYsameZleftEdge);
+
+/** BATCHED: insert the ghost cells Edge X in the node arrays */
+void parseEdgeX_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXsameYrightZrightEdge, double *ghostXsameYleftZleftEdge, double *ghostXsameYleftZrightEdge, double *ghostXsameYrightZleftEdge);
+
+/** BATCHED: add the ghost cell values Edge Z to the node arrays */
+void addEdgeZ_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXrightYrightZsameEdge, double *ghostXleftYleftZsameEdge, double *ghostXrightYleftZsameEdge, double *ghostXleftYrightZsameEdge, VirtualTopology3D * vct);
+
+/** BATCHED: add the ghost cell values Edge Y to the node arrays */
+void addEdgeY_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXrightYsameZrightEdge, double *ghostXleftYsameZleftEdge, double *ghostXleftYsameZrightEdge, double *ghostXrightYsameZleftEdge, VirtualTopology3D * vct);
+
+/** BATCHED: add the ghost cell values Edge X to the node arrays */
+void addEdgeX_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXsameYrightZrightEdge, double *ghostXsameYleftZleftEdge, double *ghostXsameYleftZrightEdge, double *ghostXsameYrightZleftEdge, VirtualTopology3D * vct);
+
+/** BATCHED: insert the ghost cell corners in the node arrays */
+void parseCorner_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXrightYrightZrightCorner, double *ghostXleftYrightZrightCorner, double *ghostXrightYleftZrightCorner, double *ghostXleftYleftZrightCorner, double *ghostXrightYrightZleftCorner, double *ghostXleftYrightZleftCorner, double *ghostXrightYleftZleftCorner, double *ghostXleftYleftZleftCorner);
+
+/** BATCHED: add the ghost cell corner values to the node arrays */
+void addCorner_batched(int nx, int ny, int nz, double ***const *vectors, int ncomp, double *ghostXrightYrightZrightCorner, double *ghostXleftYrightZrightCorner, double *ghostXrightYleftZrightCorner, double *ghostXleftYleftZrightCorner, double *ghostXrightYrightZleftCorner, double *ghostXleftYrightZleftCorner, double *ghostXrightYleftZleftCorner, double *ghostXleftYleftZleftCorner, VirtualTopology3D * vct);
+
 #endif
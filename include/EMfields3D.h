@@ -35,6 +35,7 @@ const int DFIELD_3or4=4; // 4 pads with garbage but is needed for alignment
 
 class Particles3Dcomm;
 class Moments10;
+class MomentTiles;
 class EMfields3D                // :public Field
 {
   public:
@@ -116,12 +117,16 @@ class EMfields3D                // :public Field
     void setZeroDerivedMoments();
     /*! Sum rhon over species */
     void sumOverSpecies(VirtualTopology3D * vct);
+    /*! Sum the charge density of different species on a box of nodes */
+    void sumOverSpecies(int ilo, int ihi, int jlo, int jhi, int klo, int khi);
     /*! Sum current over different species */
     void sumOverSpeciesJ();
     /*! Smoothing after the interpolation* */
     void smooth(double value, arr3_double vector, int type, Grid * grid, VirtualTopology3D * vct);
     /*! SPECIES: Smoothing after the interpolation for species fields* */
     void smooth(double value, arr4_double vector, int is, int type, Grid * grid, VirtualTopology3D * vct);
+    /*! Smoothing of three node based vectors with one exchange per sweep */
+    void smooth(double value, arr3_double vectX, arr3_double vectY, arr3_double vectZ, Grid * grid, VirtualTopology3D * vct);
     /*! smooth the electric field */
     void smoothE(double value, VirtualTopology3D * vct, Collective *col);
 
@@ -129,10 +134,19 @@ class EMfields3D                // :public Field
     void set_fieldForPcls();
     /*! communicate ghost for grid -> Particles interpolation */
     void communicateGhostP2G(int ns, int bcFaceXright, int bcFaceXleft, int bcFaceYright, int bcFaceYleft, VirtualTopology3D * vct);
+    /*! communicate ghost moments of all species, overlapped with the sum over species, the interpolation of rho to centers and the divergence of the pressures on the interior */
+    void communicateGhostP2G_overlapped(Grid * grid, VirtualTopology3D * vct);
+    /*! whether the pressures of all species are needed (for output) after the next moments */
+    void set_pressure_output(bool b){ pressureOutput = b; }
+    /*! whether the pressure of species is is summed and communicated with its moments */
+    bool sums_pressure(int is)const{ return pressureOutput || !NeglectPressure[is]; }
     /*! sum moments (interp_P2G) versions */
     void sumMoments(const Particles3Dcomm* part, Grid * grid, VirtualTopology3D * vct);
     void sumMoments_AoS(const Particles3Dcomm* part, Grid * grid, VirtualTopology3D * vct);
     void sumMoments_AoS_intr(const Particles3Dcomm* part, Grid * grid, VirtualTopology3D * vct);
+    void sumMoments_tiled(const Particles3Dcomm* part, Grid * grid, VirtualTopology3D * vct);
+    void sumMoments_colored(const Particles3Dcomm* part, Grid * grid, VirtualTopology3D * vct);
+    void sumMoments_compact(const Particles3Dcomm* part, Grid * grid, VirtualTopology3D * vct);
     void sumMoments_vectorized(const Particles3Dcomm* part, Grid * grid, VirtualTopology3D * vct);
     void sumMoments_vectorized_AoS(const Particles3Dcomm* part, Grid * grid, VirtualTopology3D * vct);
     void sumMomentsOld(const Particles3Dcomm& pcls, Grid * grid, VirtualTopology3D * vct);
@@ -388,6 +402,10 @@ class EMfields3D                // :public Field
     array3_double tempXN;
     array3_double tempYN;
     array3_double tempZN;
+    /*! -dt/2 times the divergence of the pressure of each species (for calculate hat functions) */
+    array4_double divPXC;
+    array4_double divPYC;
+    array4_double divPZC;
     /*! other temporary arrays (in MaxwellSource) */
     array3_double tempC;
     array3_double tempX;
@@ -411,6 +429,8 @@ class EMfields3D                // :public Field
     /* temporary arrays for summing moments */
     int sizeMomentsArray;
     Moments10 **moments10Array;
+    /* tiles for summing moments of sorted particles */
+    MomentTiles *momentTiles;
 
     // *******************************************************************************
     // *********** SOURCES **
@@ -496,6 +516,16 @@ class EMfields3D                // :public Field
     double *rhoINIT;
     /*! Drift of the species */
     bool *DriftSpecies;
+    /*! species whose pressure is left out of the implicit moments */
+    bool *NeglectPressure;
+    /*! true if the next moments are output (with the pressures of all species) */
+    bool pressureOutput;
+    /*! list of the arrays carried by a batched ghost exchange
+        (room for the ten moments of every species) */
+    double ****batchedVectors;
+    /*! true if divPXC, divPYC and divPZC hold the divergences of the
+        pressures of the current moments (see calculateHatFunctions()) */
+    bool divPValid;
 
     /*! boolean for divergence cleaning */
     bool PoissonCorrection;
@@ -529,6 +559,9 @@ class EMfields3D                // :public Field
     void BoundaryConditionsEImage(arr3_double imageX, arr3_double imageY, arr3_double imageZ,
       const_arr3_double vectorX, const_arr3_double vectorY, const_arr3_double vectorZ,
       int nx, int ny, int nz, VirtualTopology3D *vct,Grid *grid);
+
+    /*! the moments of all species that are summed, for batched communication */
+    int get_moment_arrays(double ***vectors[]);
 };
 
 inline void EMfields3D::addRho(double weight[][2][2], int X, int Y, int Z, int is) {
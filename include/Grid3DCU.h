@@ -77,6 +77,18 @@ public:
     const_arr4_double pYY,
     const_arr4_double pYZ,
     const_arr4_double pZZ, int ns);
+  /** calculate divergence on central points of the Tensor fields
+      of all species, multiplied by factor, on a box of cells
+      (skipping species is if skip_species[is]) */
+  void divSymmTensorN2C(arr4_double divCX, arr4_double divCY, arr4_double divCZ,
+    const_arr4_double pXX,
+    const_arr4_double pXY,
+    const_arr4_double pXZ,
+    const_arr4_double pYY,
+    const_arr4_double pYZ,
+    const_arr4_double pZZ, int num_species, double factor,
+    int ilo, int ihi, int jlo, int jhi, int klo, int khi,
+    const bool* skip_species=0);
 
   /** calculate laplacian on nodes, given a scalar field defined on nodes */
   void lapN2N(arr3_double lapN,
@@ -107,6 +119,9 @@ public:
   void interpC2N(arr3_double vecFieldN, const_arr3_double vecFieldC);
   /** interpolate on central points from nodes */
   void interpN2C(arr3_double vecFieldC, const_arr3_double vecFieldN);
+  /** interpolate on central points from nodes, on a box of cells */
+  void interpN2C(arr3_double vecFieldC, const_arr3_double vecFieldN,
+    int ilo, int ihi, int jlo, int jhi, int klo, int khi);
   /** interpolate on central points from nodes */
   void interpN2C(arr4_double vecFieldC, int ns, const_arr4_double vecFieldN);
 
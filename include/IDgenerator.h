@@ -24,6 +24,15 @@ class doubleIDgenerator
   {
     return counter[omp_get_thread_num()]++;
   }
+  // reserve n consecutive IDs (e.g. for particles
+  // to be created in parallel) and return the first
+  double generateIDs(int n)
+  {
+    double& thread_counter = counter[omp_get_thread_num()];
+    const double first = thread_counter;
+    thread_counter += n;
+    return first;
+  }
 };
 
 #endif // IDgenerator_h
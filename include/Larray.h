@@ -4,7 +4,6 @@
 #include "Alloc.h" // for ALIGNED
 #include "ipicmath.h" // for pow2roundup
 #include "asserts.h"
-#include "string.h" // for memcpy
 
 // linear array (e.g. of particles)
 // 
@@ -33,6 +32,53 @@ class Larray
       assert_lt(i, _size);
     #endif
   }
+  static size_t num_bytes(int capacity)
+  { return sizeof(type)*size_t(capacity); }
+  static type* allocate(int capacity)
+  {
+    #ifdef HAVE_MREMAP
+    if(is_mapped_alloc(num_bytes(capacity)))
+      return (type*) mapped_alloc(num_bytes(capacity));
+    #endif
+    return AlignedAlloc(type, capacity);
+  }
+  static void deallocate(type* list, int capacity)
+  {
+    #ifdef HAVE_MREMAP
+    if(is_mapped_alloc(num_bytes(capacity)))
+    {
+      mapped_free(list, num_bytes(capacity));
+      return;
+    }
+    #endif
+    AlignedFree(list);
+  }
+  // change the capacity to newcapacity (which must hold the elements)
+  void reallocate(int newcapacity)
+  {
+    assert_ge(newcapacity, _size);
+    const size_t old_bytes = num_bytes(_capacity);
+    const size_t new_bytes = num_bytes(newcapacity);
+    #ifdef HAVE_MREMAP
+    // remap the pages of a large list rather than copying them
+    if(is_mapped_alloc(old_bytes) && is_mapped_alloc(new_bytes))
+    {
+      list = (type*) mapped_realloc(list, old_bytes, new_bytes);
+      _capacity = newcapacity;
+      return;
+    }
+    #endif
+    type* oldList = list;
+    list = allocate(newcapacity);
+    // place the pages of a new list near the threads that use them
+    if(!oldList)
+      first_touch(list, new_bytes);
+    // this assumes that type has no indirection
+    else
+      memcpy(list, oldList, num_bytes(_size));
+    deallocate(oldList, _capacity);
+    _capacity = newcapacity;
+  }
  public: // access on list
   int size()const { return _size; }
   int capacity()const { return _capacity; }
@@ -84,14 +130,12 @@ class Larray
   inline const type& operator[](int i)const
   {
     check_index(i);
-    ALIGNED(list);
-    return list[i];
+    return assume_aligned_ptr(list)[i];
   }
   inline type& operator[](int i)
   {
     check_index(i);
-    ALIGNED(list);
-    return list[i];
+    return assume_aligned_ptr(list)[i];
   }
   // this extends std::vector
   void delete_element(int i)
@@ -102,13 +146,13 @@ class Larray
     // why doesn't this compile?
     //this->operator[i] = list[--_size];
     check_index(i);
-    ALIGNED(list);
-    list[i] = list[--_size];
+    type* const aligned_list = assume_aligned_ptr(list);
+    aligned_list[i] = aligned_list[--_size];
   }
  public: // memory
   ~Larray()
   {
-    AlignedFree(list);
+    deallocate(list, _capacity);
   }
   Larray():
     list(0),
@@ -121,6 +165,10 @@ class Larray
     _capacity(0)
   { if(requested_size > 0) reserve(requested_size); }
   // exchange content of this class with content of x
+  //
+  // Only the pointers are exchanged, so lists that are swapped
+  // back and forth (e.g. _pcls and _pclstmp when sorting) are
+  // not reallocated once they have grown to the needed size.
   void swap(Larray<type>& x)
   {
     // could do this with std::swap if willing to include
@@ -142,26 +190,18 @@ class Larray
   }
   // request capacity to be at least newcapacity without deleting elements
   //
-  // to bring this into conformity with std::vector, this should
-  // be change so as never to shrink the capacity.
+  // as with std::vector, this never shrinks the capacity
+  // (see shrink()), so that padding the capacity of a list
+  // every cycle does not reallocate it.
   void reserve(int newcapacity)
   {
-    // ignore request if requested size is too small
-    if(_size > newcapacity) return;
+    // ignore request if capacity is already sufficient
+    if(newcapacity <= _capacity) return;
 
     // round up size to a multiple of num_elem_in_block
     //newcapacity = roundup_to_multiple(newcapacity,num_elem_in_block);
     newcapacity = ((newcapacity-1)/num_elem_in_block+1)*num_elem_in_block;
-    if(newcapacity != _capacity)
-    {
-      _capacity = newcapacity;
-      type* oldList = list;
-      // the next two lines assume that type has no indirection
-      list = AlignedAlloc(type,_capacity);
-      memcpy(list,oldList,sizeof(type)*_size);
-      // for(int i=0;i<_size;i++) list[i] = oldList[i];
-      AlignedFree(oldList);
-    }
+    reallocate(newcapacity);
   }
   // should rename this function as shrink_to_fit to conform to std::vector.
   void realloc_if_smaller_than(int required_max_size)
@@ -171,11 +211,14 @@ class Larray
   }
   void shrink()
   {
-    // shrink _capacity by a factor of two if elements will fit.
+    // shrink _capacity by a factor of two if the elements will
+    // fill at most half of it, so that a list whose size
+    // fluctuates (e.g. with communication and injection)
+    // does not alternately shrink and grow.
     int proposed_size = pow2rounddown(_capacity/2);
-    if( _size <= proposed_size && proposed_size < _capacity)
+    if( _size <= proposed_size/2 && proposed_size < _capacity)
     {
-      reserve(proposed_size);
+      reallocate(proposed_size);
     }
   }
 };
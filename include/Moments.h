@@ -27,4 +27,89 @@ class Moments10
     ~Moments10(){};
 };
 
+// tiled accumulator for node-centered species moments
+//
+// The cells of a process subdomain (including ghost cells)
+// are split into tiles of at most tile_size cells in each
+// dimension.  The moments of particles sorted by cell are
+// accumulated for all species tile by tile, each tile in its
+// own small array that covers the nodes of its cells, so a
+// thread never writes into the array of another thread and
+// the memory used does not depend on the number of threads.
+// Only the nodes on the faces of a tile are shared with
+// neighboring tiles, so only these need to be summed over
+// more than one tile when the tiles are reduced.
+//
+// The tiles can be stored in single precision, which halves
+// their memory and the traffic of reducing them; in this case
+// the moments of each cell are summed in double precision
+// and added to the tile once, and the tiles are reduced in
+// double precision. Summing particles directly into float
+// tiles would lose accuracy as the number of particles per
+// cell grows, and compensating for this (Kahan sums or double
+// totals per tile) would need as much memory as double tiles;
+// summing each cell in double instead costs only a local
+// array and rounds each node of a tile at most 8 times.
+//
+class MomentTiles
+{
+  private:
+    // storage of the tiles (one of these is null)
+    double *arr;
+    float *arr_float;
+    int num_species;
+    // number of cells in each dimension (including ghost cells)
+    int nxc;
+    int nyc;
+    int nzc;
+    int tile_size;
+    // number of tiles in each dimension
+    int ntx;
+    int nty;
+    int ntz;
+    // number of nodes in each dimension of a tile
+    int tile_nodes;
+    // the moments of one node for each thread to reduce the tiles
+    // into, each padded to a whole number of cache lines
+    double *node_buffers;
+    int num_node_buffers;
+    int node_buffer_stride;
+  public:
+    MomentTiles(int nxc, int nyc, int nzc, int tile_size, int num_species,
+      bool single_precision=false);
+    ~MomentTiles();
+
+    int get_num_tiles()const{ return ntx*nty*ntz; }
+    int get_tile_nodes()const{ return tile_nodes; }
+    // number of doubles stored per node
+    int get_node_stride()const{ return num_species*10; }
+    // cells of tile t are [cbeg[d], cend[d]) in each dimension d
+    void get_tile_cells(int t, int cbeg[3], int cend[3])const;
+    // moments of tile t, indexed by
+    // (((i*tile_nodes+j)*tile_nodes+k)*num_species+is)*10+m,
+    // where i,j,k are node indices relative to the first cell of the tile
+    double* fetch_tile(int t)
+    { return arr + get_tile_offset(t); }
+    // single-precision version of fetch_tile
+    float* fetch_tile_float(int t)
+    { return arr_float + get_tile_offset(t); }
+    bool is_single_precision()const{ return arr_float!=0; }
+    // add the moments of node (i,j,k) of all species summed
+    // over the tiles that contain it to sum[is*10+m]
+    void add_node_moments(double* sum, int i, int j, int k);
+    // buffer of get_node_stride() doubles for thread thread_num
+    double* fetch_node_buffer(int thread_num)
+    {
+      assert_le(0,thread_num);
+      assert_lt(thread_num,num_node_buffers);
+      return node_buffers + thread_num*node_buffer_stride;
+    }
+  private:
+    size_t get_tile_offset(int t)const
+    { return size_t(t)*tile_nodes*tile_nodes*tile_nodes*get_node_stride(); }
+    // tiles (one or two) along a dimension that contain node n,
+    // and the index of n relative to the first node of each
+    int get_node_tiles(int n, int nc, int tile[2], int local[2])const;
+};
+
 #endif
@@ -22,6 +22,7 @@ developers: D. Burgess, June/July 2006
 #include "VCtopology3D.h"
 #include "MPIdata.h"
 #include "ipicdefs.h"
+#include "strided_view.h"
 
 using std::string;
 using std::stringstream;
@@ -122,6 +123,9 @@ namespace PSK {
     virtual void write(const std::string & objname, const Dimens dimens, const longid *i_array) {
       eprintf("Function not implemented");
     }
+    virtual void write(const std::string & objname, const Dimens dimens, const_strided_view<longid> i_view) {
+      eprintf("Function not implemented");
+    }
     virtual void write(const std::string & objname, const Dimens dimens, const std::vector < int >&i_array) {
       eprintf("Function not implemented");
     }
@@ -147,6 +151,9 @@ namespace PSK {
     virtual void write(const std::string & objname, const Dimens dimens, const std::vector < double >&d_array) {
       eprintf("Function not implemented");
     }
+    virtual void write(const std::string & objname, const Dimens dimens, const_strided_view<double> d_view) {
+      eprintf("Function not implemented");
+    }
 
   };
   /** bse class for output agent */
@@ -271,6 +278,9 @@ template < class Toa > class OutputAgent:public OutputAgentBase {
     void write(const std::string & objname, const Dimens dimens, const std::vector < double >&d_array) {
       std::cout << "coutPSKOutputAdaptor write vector<double> array: <" << objname << "> : " << "\n";
     }
+    void write(const std::string & objname, const Dimens dimens, const_strided_view<double> d_view) {
+      std::cout << "coutPSKOutputAdaptor write strided double array: <" << objname << "> : " << "\n";
+    }
 
   };
 
@@ -617,16 +627,16 @@ public:
       for (int i = 0; i < ns; ++i) {
         stringstream ii;
         ii << i;
-        this->output_adaptor.write("/particles/species_" + ii.str() + "/x/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getXall());
-        this->output_adaptor.write("/particles/species_" + ii.str() + "/y/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getYall());
-        this->output_adaptor.write("/particles/species_" + ii.str() + "/z/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getZall());
+        this->output_adaptor.write("/particles/species_" + ii.str() + "/x/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getXview());
+        this->output_adaptor.write("/particles/species_" + ii.str() + "/y/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getYview());
+        this->output_adaptor.write("/particles/species_" + ii.str() + "/z/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getZview());
       }
     }
     else if (tag.find("x", 0) != string::npos & sample == 0) {
       for (int i = 0; i < ns; ++i) {
         stringstream ii;
         ii << i;
-        this->output_adaptor.write("/particles/species_" + ii.str() + "/x/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getXall());
+        this->output_adaptor.write("/particles/species_" + ii.str() + "/x/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getXview());
       }
     }
     else if (tag.find("x", 0) != string::npos & sample != 0) {
@@ -668,16 +678,16 @@ public:
       for (int i = 0; i < ns; ++i) {
         stringstream ii;
         ii << i;
-        this->output_adaptor.write("/particles/species_" + ii.str() + "/u/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getUall());
-        this->output_adaptor.write("/particles/species_" + ii.str() + "/v/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getVall());
-        this->output_adaptor.write("/particles/species_" + ii.str() + "/w/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getWall());
+        this->output_adaptor.write("/particles/species_" + ii.str() + "/u/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getUview());
+        this->output_adaptor.write("/particles/species_" + ii.str() + "/v/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getVview());
+        this->output_adaptor.write("/particles/species_" + ii.str() + "/w/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getWview());
       }
     }
     else if (tag.find("u", 0) != string::npos & sample == 0) {
       for (int i = 0; i < ns; ++i) {
         stringstream ii;
         ii << i;
-        this->output_adaptor.write("/particles/species_" + ii.str() + "/u/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getUall());
+        this->output_adaptor.write("/particles/species_" + ii.str() + "/u/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getUview());
       }
     }
     else if (tag.find("u", 0) != string::npos & sample != 0) {
@@ -717,7 +727,7 @@ public:
       for (int i = 0; i < ns; ++i) {
         stringstream ii;
         ii << i;
-        this->output_adaptor.write("/particles/species_" + ii.str() + "/q/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getQall());
+        this->output_adaptor.write("/particles/species_" + ii.str() + "/q/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getQview());
       }
     }
     else if (tag.find("q", 0) != string::npos & sample != 0) {
@@ -744,7 +754,7 @@ public:
         stringstream ii;
         ii << i;
         if (_col->getTrackParticleID(i) == true)
-          this->output_adaptor.write("/particles/species_" + ii.str() + "/ID/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getParticleIDall());
+          this->output_adaptor.write("/particles/species_" + ii.str() + "/ID/cycle_" + cc.str(), PSK::Dimens(_part[i]->getNOP()), _part[i]->getParticleIDview());
 
         else if (_vct->getCartesian_rank() == 0)
           cout << "Can't write particle ID for species " + ii.str() + " because TrackParticleID is = false " << endl;
@@ -756,7 +766,7 @@ public:
       for (int i = 0; i < ns; ++i) {
         stringstream ii;
         ii << i;
-        const longid* pclID = _part[i]->getParticleIDall();
+        const_strided_view<longid> pclID = _part[i]->getParticleIDview();
         const int num_samples = _part[i]->getNOP()/sample;
         ID.reserve(num_samples);
         if (_col->getTrackParticleID(i) == true) {
@@ -22,6 +22,7 @@ namespace PSK {
     static void split_name(const std::string & name, std::vector < std::string > &elements);
 
     void get_dataset_context(const std::string & name, std::vector < hid_t > &hid_array, std::string & dataset_name);
+    void write_strided(const std::string & tag, const Dimens dimens, hid_t type_id, const void *base, int stride);
 
   public:
       HDF5OutputAdaptor(void) {;
@@ -34,6 +35,7 @@ namespace PSK {
     void write(const std::string & tag, const Dimens dimens, const int *i_array);
     void write(const std::string & tag, const Dimens dimens, const long *i_array);
     void write(const std::string & tag, const Dimens dimens, const longid *i_array);
+    void write(const std::string & tag, const Dimens dimens, const_strided_view<longid> i_view);
 
     void write(const std::string & tag, const Dimens dimens, const std::vector < int >&i_array);
 
@@ -50,6 +52,7 @@ namespace PSK {
     void write(const std::string & objname, double d);
     void write(const std::string & objname, const Dimens dimens, const double *d_array);
     void write(const std::string & objname, const Dimens dimens, const std::vector < double >&d_array);
+    void write(const std::string & objname, const Dimens dimens, const_strided_view<double> d_view);
     void write(const std::string & objname, const Dimens dimens, const_arr3_double d_array);
     void write(const std::string & objname, const Dimens dimens, const int i, const_arr4_double d_array);
 
@@ -13,6 +13,11 @@ namespace Parameters
     AoSvec,
     SoAvec,
     AoSintr,
+    // AoS moments accumulated tile by tile from cell-sorted particles
+    AoStiled,
+    // AoS moments summed straight into the species moments
+    // from cell-sorted particles, one color of tiles at a time
+    AoScolored,
     // for mover type
     SoA_vec_onesort,
     AoS_vec_onesort,
@@ -32,9 +37,40 @@ namespace Parameters
   //bool get_VECTORIZE_MOVER();
   Enum get_MOVER_TYPE();
   Enum get_MOMENTS_TYPE();
+  // number of particles in each chunk of the pool of all species
+  // pushed by the AoS mover (0 to push species one at a time)
+  int get_MOVER_CHUNK_SIZE();
+  // number of cells in each dimension of a tile of AoStiled
+  // or AoScolored moments
+  int get_MOMENT_TILE_SIZE();
+  // sum AoStiled/AoScolored moments of several particles
+  // at once in vector lanes
+  bool get_SIMD_MOMENTS();
+  // store AoStiled moment tiles in single precision
+  bool get_FLOAT_MOMENT_TILES();
+  // store particles in 32-byte single-precision cell-relative
+  // format (SpeciesParticleCompact) between pushes
+  bool get_COMPACT_PCLS();
+  // reuse the mesh cell of each particle found by the AoS mover
+  bool get_CACHE_PCL_CELLS();
+  // send particles directly to edge and corner neighbors
+  bool get_DIRECT_PCL_EXCHANGE();
+  // cycles between resampling of particles per cell
+  int get_RESAMPLE_CYCLE();
+  // draw random numbers for particles from a counter-based RNG
+  bool get_COUNTER_BASED_RNG();
+
+  // messages of BlockCommunicator carry a trailing signal
+  // element, so senders can adapt their blocks to their traffic
+  bool get_ADAPTIVE_BLOCKS();
 
   // blocksize and numblocks for use in BlockCommunicator
+  // (with ADAPTIVE_BLOCKS, senders adapt the size of their
+  // blocks to their traffic between minBlockSize and blockSize,
+  // and the number of blocks grows if sends do not complete
+  // in time)
   int get_blockSize();
   int get_numBlocks();
+  int get_minBlockSize();
 }
 #endif
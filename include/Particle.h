@@ -13,7 +13,10 @@ namespace ParticleType
   {
     AoS = 0,
     SoA,
-    synched
+    synched,
+    // single-precision cell-relative representation
+    // (see SpeciesParticleCompact)
+    compact
   };
 }
 
@@ -107,6 +110,66 @@ class SpeciesParticle
   }
 };
 
+// intended to occupy 32 bytes
+//
+// compact particle for a specific species.
+//
+// The position is stored relative to the mesh cell that
+// contains it: cell holds the (guarded) cell coordinates
+// cx,cy,cz of the process subgrid packed into 10 bits each,
+// and dx[i] in [0,1) is the fractional offset of the particle
+// within that cell.  Cell coordinates are stored with a bias
+// so that particles which have just left the subdomain
+// (e.g. at the end of a push) remain representable.
+// Velocity and charge are single precision.  There is no room
+// for the subcycle time/ID, so tracked particles cannot use
+// this representation.
+//
+// Absolute positions are reconstructed only where needed
+// (boundary conditions, communication, and output);
+// see Particles3Dcomm::pack_pcl() and unpack_pcl().
+class SpeciesParticleCompact
+{
+  unsigned int cell;
+  float dx[3];
+  float u[3];
+  float q;
+ public:
+  // number of bits used to store each cell coordinate
+  static const int CELL_BITS = 10;
+  static const unsigned int CELL_MASK = (1u<<CELL_BITS)-1;
+  // offset added to each stored cell coordinate
+  static const int CELL_BIAS = 1<<(CELL_BITS-2);
+  // range of cell coordinates that can be represented
+  static int min_cell(){ return -CELL_BIAS; }
+  static int max_cell(){ return int(CELL_MASK)-CELL_BIAS; }
+ public:
+  SpeciesParticleCompact(){}
+  // accessors
+  int get_cx()const{ return int(cell&CELL_MASK)-CELL_BIAS; }
+  int get_cy()const{ return int((cell>>CELL_BITS)&CELL_MASK)-CELL_BIAS; }
+  int get_cz()const{ return int((cell>>(2*CELL_BITS))&CELL_MASK)-CELL_BIAS; }
+  unsigned int get_cell()const{ return cell; }
+  float get_dx(int i)const{ return dx[i]; }
+  float get_u(int i)const{ return u[i]; }
+  float get_u()const{ return u[0]; }
+  float get_v()const{ return u[1]; }
+  float get_w()const{ return u[2]; }
+  float get_q()const{ return q; }
+  // the caller is responsible for checking the range of cx,cy,cz
+  void set_cell(int cx, int cy, int cz)
+  {
+    cell = (unsigned(cx+CELL_BIAS)&CELL_MASK)
+      | ((unsigned(cy+CELL_BIAS)&CELL_MASK)<<CELL_BITS)
+      | ((unsigned(cz+CELL_BIAS)&CELL_MASK)<<(2*CELL_BITS));
+  }
+  void set_dx(float dx_, float dy_, float dz_)
+  { dx[0]=dx_; dx[1]=dy_; dx[2]=dz_; }
+  void set_u(float u_, float v_, float w_)
+  { u[0]=u_; u[1]=v_; u[2]=w_; }
+  void set_q(float in){ q=in; }
+};
+
 // to support SoA notation
 //
 // this class will simply be defined differently
@@ -61,10 +61,18 @@ class Particles3D:public Particles3Dcomm {
     void RotatePlaneXY(double theta);
     /** mover with the esplicit non relativistic scheme */
     void mover_explicit(Field * EMf);
-    /** mover with a Predictor-Corrector Scheme */
+    /** mover with a Predictor-Corrector Scheme
+        (the PC movers end without a barrier; call
+        separate_and_send_particles() before using the particles) */
     void mover_PC(Field * EMf);
     /** array-of-structs version of mover_PC */
     void mover_PC_AoS(Field * EMf);
+    /** mover_PC_AoS for all species as one pool of chunks
+        of particles (see MOVER_CHUNK_SIZE) */
+    static void mover_PC_AoS_in_chunks(
+      Particles3D* part, int num_species, Field * EMf);
+    /** version of mover_PC_AoS for compact particles */
+    void mover_PC_compact(Field * EMf);
     /* vectorized version of previous */
     void mover_PC_AoS_vec(Field * EMf);
     /* mic particle mover */
@@ -76,14 +84,30 @@ class Particles3D:public Particles3Dcomm {
     /** relativistic mover with a Predictor-Corrector scheme */
     int mover_relativistic(Field * EMf);
    private:
+    /** push one particle (see mover_PC_AoS) */
+    void push_pcl_AoS(SpeciesParticle* pcl,
+      const_arr4_pfloat& fieldForPcls, double dto2, double qdto2mc);
+    /** push the particles of one chunk (see mover_PC_AoS_in_chunks) */
+    void push_chunk_AoS(int chunk, int chunk_size,
+      bool caching_cells, const_arr4_pfloat& fieldForPcls);
+    /** maxwellian() with cells filled in parallel (counter-based RNG) */
+    void maxwellian_in_parallel(Field * EMf, bool perturb_vy);
     /** repopulate particles in a single cell */
-    void populate_cell_with_particles(int i, int j, int k, double q,
+    void populate_cell_with_particles(
+      SpeciesParticle* pcls, double first_ID,
+      int i, int j, int k, double q,
       double dx_per_pcl, double dy_per_pcl, double dz_per_pcl);
+    /** replace a group of particles with two equivalent particles */
+    void merge_particles(const int* pidx, int n);
+    /** replace a particle in a cell with two half-weight particles */
+    void split_particle(const SpeciesParticle& pcl, int cx, int cy, int cz);
    public:
     /** repopulate particles in boundary layer */
     void repopulate_particles();
     /*! Delete the particles inside the sphere with radius R and center x_center y_center and return the total charge removed */
     double deleteParticlesInsideSphere(double R, double x_center, double y_center, double z_center);
+    /** merge and split particles to keep the number per cell near npcel */
+    void resample_particles();
 
 #ifdef BATSRUS
     /*! Initial condition: given a fluid model (BATSRUS) */
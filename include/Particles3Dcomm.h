@@ -15,6 +15,7 @@ developers: Stefano Markidis, Giovanni Lapenta
 #include "BlockCommunicator.h"
 #include "aligned_vector.h"
 #include "Larray.h"
+#include "strided_view.h"
 #include "IDgenerator.h"
 /**
  * 
@@ -72,13 +73,53 @@ public:
   void apply_BCs_globally(vector_SpeciesParticle& pcl_list);
   void apply_BCs_locally(vector_SpeciesParticle& pcl_list,
     int direction, bool apply_shift, bool do_apply_BCs);
+  void apply_periodic_shifts(vector_SpeciesParticle& pcl_list,
+    const bool shift[3]);
  private: // communicate particles between processes
   void flush_send();
+  void start_sending_and_receiving();
   bool send_pcl_to_appropriate_buffer(SpeciesParticle& pcl, int count[6]);
+  bool send_pcl_directly(SpeciesParticle& pcl, int count[6]);
   int handle_received_particles(int pclCommMode=0);
+ protected: // send emigrants as they are found by the mover
+  void begin_emitting_emigrants(bool caching_cells=false);
+  void emit_emigrant(SpeciesParticle& pcl, int pidx, int thread_num);
+  // call for each particle once it has been pushed
+  void emit_if_emigrant(SpeciesParticle& pcl, int pidx, int thread_num)
+  {
+    if(__builtin_expect(test_outside_subdomain(pcl),false))
+      emit_emigrant(pcl, pidx, thread_num);
+  }
+  // same, for a particle whose cell has just been cached
+  void emit_if_emigrant(SpeciesParticle& pcl, const int cell[3],
+    int pidx, int thread_num)
+  {
+    if(__builtin_expect(test_outside_subdomain(pcl, cell),false))
+      emit_emigrant(pcl, pidx, thread_num);
+  }
+ protected: // send emigrants of chunks of particles pushed in any order
+  void begin_emitting_chunks(int chunk_size, bool caching_cells);
+  int get_num_chunks()const{ return num_chunks; }
+  // call for each particle of chunk once it has been pushed
+  void list_if_chunk_emigrant(const SpeciesParticle& pcl, int pidx, int chunk)
+  {
+    if(__builtin_expect(test_outside_subdomain(pcl),false))
+      chunk_emigrant_idx[chunk].push_back(pidx);
+  }
+  // same, for a particle whose cell has just been cached
+  void list_if_chunk_emigrant(const SpeciesParticle& pcl, const int cell[3],
+    int pidx, int chunk)
+  {
+    if(__builtin_expect(test_outside_subdomain(pcl, cell),false))
+      chunk_emigrant_idx[chunk].push_back(pidx);
+  }
+  void finish_chunk(int chunk);
+  bool send_emigrants_of_finished_chunks();
  public:
   int separate_and_send_particles();
   void recommunicate_particles_until_done(int min_num_iterations=3);
+  static void recommunicate_species_until_done(Particles3Dcomm* part,
+    int num_species, int min_num_iterations=3);
   void communicate_particles();
   void pad_capacities();
  private:
@@ -86,17 +127,99 @@ public:
   void resize_SoA(int nop);
   void copyParticlesToAoS();
   void copyParticlesToSoA();
+  void copyParticlesToCompact();
+  void copyParticlesFromCompact();
 
  public:
   void convertParticlesToSynched();
   void convertParticlesToAoS();
   void convertParticlesToSoA();
+  void convertParticlesToCompact();
   bool particlesAreSoA()const;
 
+  // conversion between absolute and cell-relative representation
+  //
+  void pack_pcl(SpeciesParticleCompact& cpcl, const SpeciesParticle& pcl)const
+  {
+    // cell position minus 1 (due to ghost cells)
+    const double cxm1_pos = (pcl.get_x() - xstart) * inv_dx;
+    const double cym1_pos = (pcl.get_y() - ystart) * inv_dy;
+    const double czm1_pos = (pcl.get_z() - zstart) * inv_dz;
+    const double cxm1 = floor(cxm1_pos);
+    const double cym1 = floor(cym1_pos);
+    const double czm1 = floor(czm1_pos);
+    const int cx = 1 + int(cxm1);
+    const int cy = 1 + int(cym1);
+    const int cz = 1 + int(czm1);
+    // the particle must not have strayed too far from this subdomain
+    assert_ge(cx, SpeciesParticleCompact::min_cell());
+    assert_ge(cy, SpeciesParticleCompact::min_cell());
+    assert_ge(cz, SpeciesParticleCompact::min_cell());
+    assert_le(cx, SpeciesParticleCompact::max_cell());
+    assert_le(cy, SpeciesParticleCompact::max_cell());
+    assert_le(cz, SpeciesParticleCompact::max_cell());
+    cpcl.set_cell(cx,cy,cz);
+    cpcl.set_dx(cxm1_pos-cxm1, cym1_pos-cym1, czm1_pos-czm1);
+    cpcl.set_u(pcl.get_u(), pcl.get_v(), pcl.get_w());
+    cpcl.set_q(pcl.get_q());
+  }
+  // reconstruct absolute position of compact particle
+  void get_pcl_position(const SpeciesParticleCompact& cpcl,
+    double& x, double& y, double& z)const
+  {
+    x = xstart + ((cpcl.get_cx()-1) + double(cpcl.get_dx(0))) * dx;
+    y = ystart + ((cpcl.get_cy()-1) + double(cpcl.get_dx(1))) * dy;
+    z = zstart + ((cpcl.get_cz()-1) + double(cpcl.get_dx(2))) * dz;
+  }
+  void unpack_pcl(SpeciesParticle& pcl, const SpeciesParticleCompact& cpcl)const
+  {
+    double x,y,z;
+    get_pcl_position(cpcl, x,y,z);
+    pcl.set(cpcl.get_u(), cpcl.get_v(), cpcl.get_w(), cpcl.get_q(),
+      x, y, z, 0.);
+  }
+  // true if the particle is outside the subdomain of this process
+  bool test_outside_subdomain(const SpeciesParticle& pcl)const
+  {
+    return
+         pcl.get_x() < xstart || pcl.get_x() > xend
+      || pcl.get_y() < ystart || pcl.get_y() > yend
+      || pcl.get_z() < zstart || pcl.get_z() > zend;
+  }
+  // cell of the particle (possibly outside the subdomain)
+  // as computed by Grid3DCU::get_cell_coordinates()
+  void get_pcl_cell(int cell[3], const SpeciesParticle& pcl)const
+  {
+    cell[0] = 1 + int(floor((pcl.get_x() - xstart) * inv_dx));
+    cell[1] = 1 + int(floor((pcl.get_y() - ystart) * inv_dy));
+    cell[2] = 1 + int(floor((pcl.get_z() - zstart) * inv_dz));
+  }
+  // test_outside_subdomain() for a particle whose cell is known;
+  // the position need be checked only in cells next to ghost cells
+  bool test_outside_subdomain(const SpeciesParticle& pcl, const int cell[3])const
+  {
+    if(cell[0] > 1 && cell[0] < nxc-2
+    && cell[1] > 1 && cell[1] < nyc-2
+    && cell[2] > 1 && cell[2] < nzc-2)
+      return false;
+    return test_outside_subdomain(pcl);
+  }
+  // true if the particle is not in a proper cell of this subdomain
+  bool test_outside_subdomain_cells(const SpeciesParticleCompact& cpcl)const
+  {
+    return
+         cpcl.get_cx() < 1 || cpcl.get_cx() > nxc-2
+      || cpcl.get_cy() < 1 || cpcl.get_cy() > nyc-2
+      || cpcl.get_cz() < 1 || cpcl.get_cz() > nzc-2;
+  }
+
   /*! sort particles for vectorized push (needs to be parallelized) */
   //void sort_particles_serial_SoA_by_xavg();
   void sort_particles_serial();
   void sort_particles_serial_AoS();
+  // compute the cached cells of particles added since the push
+  // (if CACHE_PCL_CELLS)
+  void update_pcl_cells();
   //void sort_particles_serial_SoA();
 
   // get accessors for optional arrays
@@ -129,6 +252,7 @@ public:
 
   void delete_particle(int pidx)
   {
+    _pcl_cell.clear();
     _pcls[pidx]=_pcls.back();
     _pcls.pop_back();
     //_pcls.delete_element(pidx);
@@ -148,6 +272,14 @@ public:
   ParticleType::Type get_particleType()const { return particleType; }
   const SpeciesParticle& get_pcl(int pidx)const{ return _pcls[pidx]; }
   const vector_SpeciesParticle& get_pcl_list()const{ return _pcls; }
+  const SpeciesParticleCompact& get_cpcl(int pidx)const{ return _cpcls[pidx]; }
+  // cached cells of the AoS particles (three per particle),
+  // or NULL unless every particle has one
+  const int* get_pcl_cells()const
+  {
+    return (_pcls.size() && _pcl_cell.size()==3*_pcls.size()) ?
+      &_pcl_cell[0] : 0;
+  }
   const double *getUall()  const { assert(particlesAreSoA()); return &u[0]; }
   const double *getVall()  const { assert(particlesAreSoA()); return &v[0]; }
   const double *getWall()  const { assert(particlesAreSoA()); return &w[0]; }
@@ -174,9 +306,44 @@ public:
     }
     return ret;
   }
+  // views of particle components in the current representation
+  //
+  // These access the AoS list directly when SoA data is not
+  // current, so readers need not transpose the particles.
+  // Compact particles must first be expanded.
+  const_strided_view<double> getUview()const{ return view_component(0,u); }
+  const_strided_view<double> getVview()const{ return view_component(1,v); }
+  const_strided_view<double> getWview()const{ return view_component(2,w); }
+  const_strided_view<double> getQview()const{ return view_component(ID_field::Q,q); }
+  const_strided_view<double> getXview()const{ return view_component(4,x); }
+  const_strided_view<double> getYview()const{ return view_component(5,y); }
+  const_strided_view<double> getZview()const{ return view_component(6,z); }
+  const_strided_view<longid> getParticleIDview()const
+  {
+    // reinterprets the bits of t, as does getParticleIDall()
+    const_strided_view<double> tview = view_component(ID_field::T,t);
+    return const_strided_view<longid>(
+      (const longid*) tview.get_base(), tview.get_stride());
+  }
+ private:
+  const_strided_view<double> view_component(int offset,
+    const vector_double& soa_component)const
+  {
+    assert(particleType!=ParticleType::compact);
+    if(particlesAreSoA())
+      return const_strided_view<double>(&soa_component[0], 1);
+    const int stride = sizeof(SpeciesParticle)/sizeof(double);
+    const double* base = (const double*) &_pcls[0];
+    return const_strided_view<double>(base+offset, stride);
+  }
+ public:
   // accessors for particle with index indexPart
   //
-  int getNOP()  const { return _pcls.size(); }
+  int getNOP()  const
+  {
+    if(particleType==ParticleType::compact) return _cpcls.size();
+    return _pcls.size();
+  }
   // set particle components
   void setU(int i, double in){_pcls[i].set_u(in);}
   void setV(int i, double in){_pcls[i].set_v(in);}
@@ -272,6 +439,9 @@ protected:
   double w0;
   // used to generate unique particle IDs
   doubleIDgenerator pclIDgenerator;
+  // number of times that particles have been repopulated
+  // (selects streams of the counter-based random number generator)
+  int num_repopulations;
 
   ParticleType::Type particleType;
   //
@@ -280,6 +450,41 @@ protected:
   //Larray<SpeciesParticle> _pcls;
   vector_SpeciesParticle _pcls;
   //
+  // compact representation
+  // (authoritative if particleType is compact)
+  //
+  vector_SpeciesParticleCompact _cpcls;
+  //
+  // mesh cell of each AoS particle where its push ended
+  // (three entries per particle, valid for the first
+  // _pcl_cell.size()/3 particles; see CACHE_PCL_CELLS)
+  //
+  vector_int _pcl_cell;
+  vector_int _pcl_celltmp;
+  //
+  // structures for separating emigrating particles
+  //
+  // indices of candidate emigrants found by each thread
+  vector_int* emigrant_idx;
+  int num_emigrant_lists;
+  // indices (in increasing order) of particles that were sent
+  vector_int sent_idx;
+  // indices of particles used to fill the holes they leave
+  vector_int fill_idx;
+  // true if the mover has already listed the emigrants
+  bool emigrants_emitted;
+  // number of particles sent in each direction by the mover
+  int emit_count[6];
+  // emigrants of each chunk of particles pushed by a chunked mover
+  // (see begin_emitting_chunks())
+  vector_int* chunk_emigrant_idx;
+  // nonzero once each chunk has been pushed
+  int* chunk_done;
+  int num_chunks;
+  int max_num_chunks;
+  // first chunk whose emigrants have not yet been sent
+  int next_chunk_to_send;
+  //
   // particles data
   //
   // SoA representation
@@ -370,6 +575,21 @@ protected:
   BlockCommunicator<SpeciesParticle> recvYrght;
   BlockCommunicator<SpeciesParticle> recvZleft;
   BlockCommunicator<SpeciesParticle> recvZrght;
+  //
+  // buffers for direct exchange with edge and corner neighbors
+  // (see Parameters::get_DIRECT_PCL_EXCHANGE())
+  //
+  bool direct_exchange;
+  // number of edge and corner neighbors that exist
+  int num_diag_nbrs;
+  BlockCommunicator<SpeciesParticle> sendDiag[20];
+  BlockCommunicator<SpeciesParticle> recvDiag[20];
+  // index in sendDiag and recvDiag of each neighbor offset
+  // (-1 if there is no such edge or corner neighbor)
+  int diag_idx[27];
+  // whether particles received from each edge or corner neighbor
+  // have crossed a periodic boundary in each dimension
+  bool diag_shift[20][3];
 
   /** bool for communication verbose */
   bool cVERBOSE;
@@ -75,6 +75,11 @@ public:
   int getYrght()const{ return (yright_neighbor); }
   int getZleft()const{ return (zleft_neighbor); }
   int getZrght()const{ return (zright_neighbor); }
+  // rank of the neighbor whose cartesian coordinates differ
+  // from ours by (dx,dy,dz), where each offset is -1, 0, or 1
+  // (MPI_PROC_NULL if there is no such process)
+  int getNeighbor(int dx, int dy, int dz)const
+  { return neighbor[dx+1][dy+1][dz+1]; }
 
   bool isPeriodicXlower()const{ return _isPeriodicXlower; }
   bool isPeriodicXupper()const{ return _isPeriodicXupper; }
@@ -168,6 +173,8 @@ private:
   int zleft_neighbor;
   /** cartesian rank of ZLEFT neighbor */
   int zright_neighbor;
+  /** cartesian ranks of the 26 neighbors (including edges and corners) */
+  int neighbor[3][3][3];
   /** cartesian rank of XLEFT neighbor */
   //int xleft_neighbor_P;
   /** cartesian rank of XRIGHT neighbor */
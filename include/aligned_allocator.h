@@ -6,7 +6,7 @@
 //#include <stdint.h>
 #include <cstddef> // for std::size_t
 #include <stdexcept> // for std::length_error
-//#include <stdlib.h> // for posix_memalign or aligned_alloc
+#include <stdlib.h> // for posix_memalign
 //#include <malloc.h> // for memalign(alignment, size)
 //#include <stdio.h> // for printf
 #include "errors.h" // for eprintf
@@ -119,14 +119,11 @@ class aligned_allocator
       // Mallocator wraps malloc().
 #ifdef __INTEL_COMPILER
       void * const pv = _mm_malloc(n * sizeof(T), Alignment);
-#else // is there a way to test whether posix_memalign is available?
-      //void * const pv = new T[n];
-      // this is supposed to be aligned with SSE types anyway...
-      void * const pv = malloc(n*sizeof(T));
-      // should I use posix_memalign()?
-      //void * const pv = memalign(Alignment, n*sizeof(T));
-      //void * pv;
-      //posix_memalign(&pv, Alignment, n*sizeof(T));
+#else
+      // malloc() aligns only for SSE types
+      void * pv = NULL;
+      if(posix_memalign(&pv, Alignment, n*sizeof(T)))
+        pv = NULL;
 #endif
  
       // Allocators should throw std::bad_alloc in the case of memory allocation failure.
@@ -145,7 +142,7 @@ class aligned_allocator
 #ifdef __INTEL_COMPILER
       _mm_free(p);
 #else
-     free(p); // for memalign
+     free(p); // for posix_memalign
 #endif
     }
  
@@ -26,5 +26,8 @@
 //typedef aligned_vector<SpeciesParticle>::type SpeciesParticleVector;
 class SpeciesParticle;
 typedef aligned_vector(SpeciesParticle) vector_SpeciesParticle;
+class SpeciesParticleCompact;
+typedef aligned_vector(SpeciesParticleCompact) vector_SpeciesParticleCompact;
 typedef aligned_vector(double) vector_double;
+typedef aligned_vector(int) vector_int;
 
@@ -46,9 +46,10 @@ namespace iPic3D {
       my_clock(0)
     {}
     int Init(int argc, char **argv);
-    void CalculateMoments();
+    void CalculateMoments(int cycle);
     void CalculateField(); //! calculate Efield
     bool ParticlesMover();
+    void ResampleParticles(int cycle);
     void CalculateB();
     //
     // output methods
@@ -71,7 +72,9 @@ namespace iPic3D {
     void convertParticlesToSoA();
     void convertParticlesToAoS();
     void convertParticlesToSynched();
+    void convertParticlesToCompact();
     void sortParticles();
+    bool writesFields(int cycle);
 
   private:
     //static MPIdata * mpi;
@@ -0,0 +1,112 @@
+#ifndef philox_h
+#define philox_h
+
+#include <stdint.h> // for uint32_t, uint64_t
+#include <math.h> // for sqrt, log, cos, sin
+
+// Counter-based random number generator
+//
+// This implements the Philox4x32-10 generator of Salmon et al.,
+// "Parallel random numbers: as easy as 1, 2, 3" (SC11).
+// Each block of four 32-bit random numbers is a pure function of
+// a two-word key and a four-word counter, so there is no state to
+// share or to advance: a stream of random numbers can be assigned
+// to each particle (e.g. keyed by process and species, with a
+// counter made of cell and particle indices), and particles can
+// then be generated in any order, by any number of threads, with
+// identical results.
+//
+inline void philox4x32_10(uint32_t out[4],
+  const uint32_t ctr_in[4], const uint32_t key_in[2])
+{
+  uint32_t ctr[4] = {ctr_in[0], ctr_in[1], ctr_in[2], ctr_in[3]};
+  uint32_t key[2] = {key_in[0], key_in[1]};
+  for(int round=0;round<10;round++)
+  {
+    if(round)
+    {
+      // bump the key (Weyl sequence)
+      key[0] += 0x9E3779B9u;
+      key[1] += 0xBB67AE85u;
+    }
+    const uint64_t prod0 = uint64_t(0xD2511F53u)*ctr[0];
+    const uint64_t prod1 = uint64_t(0xCD9E8D57u)*ctr[2];
+    const uint32_t hi0 = uint32_t(prod0>>32);
+    const uint32_t lo0 = uint32_t(prod0);
+    const uint32_t hi1 = uint32_t(prod1>>32);
+    const uint32_t lo1 = uint32_t(prod1);
+    ctr[0] = hi1 ^ ctr[1] ^ key[0];
+    ctr[1] = lo1;
+    ctr[2] = hi0 ^ ctr[3] ^ key[1];
+    ctr[3] = lo0;
+  }
+  for(int i=0;i<4;i++) out[i] = ctr[i];
+}
+
+// stream of random numbers for a single consumer (e.g. particle)
+//
+// Successive blocks of the stream increment the last word of the
+// counter, so consumers that start their counters in the same
+// first three words should space the last word apart by at least
+// the number of blocks that each uses (e.g. particle index * 256).
+//
+class PhiloxStream
+{
+  uint32_t key[2];
+  uint32_t ctr[4];
+  uint32_t out[4];
+  int next; // index of next unused number in out
+ private:
+  uint32_t sample_uint32()
+  {
+    if(next==4)
+    {
+      philox4x32_10(out, ctr, key);
+      ctr[3]++;
+      next = 0;
+    }
+    return out[next++];
+  }
+ public:
+  PhiloxStream(uint32_t key0, uint32_t key1,
+    uint32_t ctr0, uint32_t ctr1, uint32_t ctr2, uint32_t ctr3):
+    next(4)
+  {
+    key[0] = key0; key[1] = key1;
+    ctr[0] = ctr0; ctr[1] = ctr1; ctr[2] = ctr2; ctr[3] = ctr3;
+  }
+  // sample from unit interval [0,1)
+  double sample_u_double()
+  {
+    const double two_to_minus_32 = 1./4294967296.;
+    return sample_uint32()*two_to_minus_32;
+  }
+  // sample from clopen interval (0,1]
+  double sample_clopen_u_double()
+  {
+    const double two_to_minus_32 = 1./4294967296.;
+    return (double(sample_uint32())+1.)*two_to_minus_32;
+  }
+  // as in ipicmath.h
+  void sample_standard_maxwellian(double& u, double& v)
+  {
+    const double prob = sqrt(-2.0 * log(sample_clopen_u_double()));
+    const double theta = 2.0 * M_PI * sample_u_double();
+    u = prob * cos(theta);
+    v = prob * sin(theta);
+  }
+  void sample_maxwellian(
+    double& u, double& v, double& w,
+    double ut, double vt, double wt,
+    double u0, double v0, double w0)
+  {
+    double unused;
+    sample_standard_maxwellian(u,v);
+    sample_standard_maxwellian(w,unused);
+    u = u0 + ut*u;
+    v = v0 + vt*v;
+    w = w0 + wt*w;
+  }
+};
+
+#endif
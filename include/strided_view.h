@@ -0,0 +1,28 @@
+#ifndef strided_view_h
+#define strided_view_h
+
+// read-only view of every stride-th element of an array
+//
+// This is used to access one component of a list of particles
+// without caring whether the list is stored as an array of
+// structs (stride = number of components) or as a struct of
+// arrays (stride = 1), so that consumers of particle data
+// (e.g. moment accumulation and output) do not require
+// the particles to be transposed.
+//
+template <class type>
+class const_strided_view
+{
+  const type* base;
+  int stride;
+ public:
+  const_strided_view(const type* base_, int stride_):
+    base(base_),
+    stride(stride_)
+  {}
+  const type& operator[](int i)const{ return base[i*stride]; }
+  const type* get_base()const{ return base; }
+  int get_stride()const{ return stride; }
+};
+
+#endif
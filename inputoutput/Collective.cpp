@@ -387,6 +387,23 @@ void Collective::ReadInput(string inputfile) {
     if (ns > 5)
         TrackParticleID[5] = TrackParticleID0.f;
     
+    // the pressure tensor of these species is left out of the
+    // implicit moments, so it is computed only for output
+    NeglectPressure = new bool[ns];
+    array_bool NeglectPressure_DEFAULT(0, 0, 0, 0, 0, 0);
+    array_bool NeglectPressure0 = config.read < array_bool > ("NeglectPressure",NeglectPressure_DEFAULT);
+    NeglectPressure[0] = NeglectPressure0.a;
+    if (ns > 1)
+        NeglectPressure[1] = NeglectPressure0.b;
+    if (ns > 2)
+        NeglectPressure[2] = NeglectPressure0.c;
+    if (ns > 3)
+        NeglectPressure[3] = NeglectPressure0.d;
+    if (ns > 4)
+        NeglectPressure[4] = NeglectPressure0.e;
+    if (ns > 5)
+        NeglectPressure[5] = NeglectPressure0.f;
+    
     
     
     
@@ -734,6 +751,7 @@ Collective::~Collective() {
     delete[]w0;
     
     delete[]TrackParticleID;
+    delete[]NeglectPressure;
     
     delete[]rhoINIT;
     delete[]rhoINJECT;
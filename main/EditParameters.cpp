@@ -0,0 +1,71 @@
+// The parameters to edit, in their own file so that
+// tests can link their own definitions in place of these
+// (see tests/TestParameters.cpp); the parameters derived from
+// them are in Parameters.cpp
+//
+#include "Parameters.h"
+
+using namespace Parameters;
+
+//********** edit these parameters *********
+//
+bool Parameters::get_VECTORIZE_MOMENTS() { return false; }
+// supported options: SoA AoS AoStiled AoScolored
+Parameters::Enum Parameters::get_MOMENTS_TYPE() { return AoS; }
+// for AoStiled moments, the cells of each process are split into
+// tiles of (at most) this many cells in each dimension; each tile
+// is accumulated by one thread in an array small enough to stay in
+// cache, so memory use does not grow with the number of threads;
+// for AoScolored moments, tiles with the same parity of tile
+// indices are summed concurrently straight into the moments
+int Parameters::get_MOMENT_TILE_SIZE() { return 8; }
+// if true, AoStiled/AoScolored moments of each mesh cell are summed
+// several particles at a time in vector lanes (portable,
+// without intrinsics); results agree with the scalar sum
+// up to roundoff
+bool Parameters::get_SIMD_MOMENTS() { return false; }
+// if true, AoStiled tiles store moments in single precision,
+// halving their memory and the traffic of reducing them; the
+// moments of each cell are summed in double before they are
+// added to the tile, so that the roundoff (a few float epsilons
+// of the moments) does not grow with the particles per cell,
+// and tiles are reduced in double
+bool Parameters::get_FLOAT_MOMENT_TILES() { return false; }
+// supported options: SoA AoS AoSvec AoSintr AoS_vec_onesort SoA_vec_resort
+Parameters::Enum Parameters::get_MOVER_TYPE() { return AoS; }
+// if positive, the AoS mover pushes the particles of all species
+// as one pool of chunks of this many particles; threads take the
+// next chunk of any species as they become free, so the work of
+// a heavy species spreads over threads that finished a light one,
+// and the master thread sends the emigrants of each species chunk
+// by chunk while the other chunks are still being pushed
+int Parameters::get_MOVER_CHUNK_SIZE() { return 0; }
+// if true, particles are pushed and their moments are summed
+// in compact format (overrides MOVER_TYPE and MOMENTS_TYPE;
+// not supported for species with TrackParticleID)
+bool Parameters::get_COMPACT_PCLS() { return false; }
+// if true, the AoS mover records the mesh cell in which each
+// particle ends its push, and the emigrant check, the sort, and
+// AoS moments use it rather than recomputing it from the position
+// (costs 12 bytes per particle)
+bool Parameters::get_CACHE_PCL_CELLS() { return false; }
+// if true, emigrating particles are sent directly to the
+// appropriate one of the 26 neighboring processes (including
+// edge and corner neighbors) rather than one dimension at a time
+bool Parameters::get_DIRECT_PCL_EXCHANGE() { return false; }
+// if positive, every so many cycles the particles of each cell
+// are merged or split to keep their number near npcel
+// (conserving charge, momentum, and energy)
+int Parameters::get_RESAMPLE_CYCLE() { return 0; }
+// if true, particles are initialized with a counter-based random
+// number generator (Philox), so that initialization can be threaded
+// and is bit-reproducible independent of the number of threads
+// (repopulated particles always use it, so that the cells of the
+// boundary layers are filled in parallel)
+bool Parameters::get_COUNTER_BASED_RNG() { return false; }
+// if true, each message of a BlockCommunicator carries an extra
+// trailing element with its signal; this lets senders choose the
+// size of their blocks from their traffic and add blocks rather
+// than wait for sends to complete (changes the message format,
+// so all processes must agree)
+bool Parameters::get_ADAPTIVE_BLOCKS() { return false; }
@@ -2,13 +2,8 @@
 
 using namespace Parameters;
 
-//********** edit these parameters *********
-//
-bool Parameters::get_VECTORIZE_MOMENTS() { return false; }
-// supported options: SoA AoS
-Parameters::Enum Parameters::get_MOMENTS_TYPE() { return AoS; }
-// supported options: SoA AoS AoSvec AoSintr AoS_vec_onesort SoA_vec_resort
-Parameters::Enum Parameters::get_MOVER_TYPE() { return AoS; }
+// (the parameters to edit are in EditParameters.cpp)
+
 //********** derived parameters *********
 
 static bool SORTING_PARTICLES;
@@ -22,6 +17,8 @@ void Parameters::init_parameters()
        get_MOVER_TYPE()==SoA_vec_resort
     || get_MOVER_TYPE()==AoS_vec_resort;
   SORTING_PARTICLES = get_VECTORIZE_MOMENTS()
+    || get_MOMENTS_TYPE()==AoStiled
+    || get_MOMENTS_TYPE()==AoScolored
     || get_MOVER_TYPE()==SoA_vec_onesort
     || get_MOVER_TYPE()==AoS_vec_onesort
     || get_MOVER_TYPE()==SoA_vec_resort
@@ -29,8 +26,10 @@ void Parameters::init_parameters()
   SORTING_SOA = get_VECTORIZE_MOMENTS()
     || get_MOVER_TYPE()==SoA_vec_onesort
     || get_MOVER_TYPE()==SoA_vec_resort;
-  USING_AOS =
-       get_MOMENTS_TYPE()==AoS
+  USING_AOS = get_COMPACT_PCLS()
+    || get_MOMENTS_TYPE()==AoS
+    || get_MOMENTS_TYPE()==AoStiled
+    || get_MOMENTS_TYPE()==AoScolored
     || get_MOVER_TYPE()==AoS
     || get_MOVER_TYPE()==AoSintr
     || get_MOVER_TYPE()==AoS_vec_onesort
@@ -44,6 +43,7 @@ bool Parameters::get_USING_AOS() { return USING_AOS; }
 // int Parameters::get_blockSize() { return 64; }
 int Parameters::get_blockSize() { return 2048; }
 int Parameters::get_numBlocks() { return 4; }
+int Parameters::get_minBlockSize() { return 64; }
 
 //bool Parameters::get_RESORTING_PARTICLES() { return true; }
 //bool Parameters::get_SORTING_PARTICLES() { return true; }
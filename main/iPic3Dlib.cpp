@@ -221,14 +221,29 @@ void c_Solver::sortParticles() {
   timeTasks_end_task(TimeTasks::MOMENT_PCL_SORTING);
 }
 
-void c_Solver::CalculateMoments() {
+// cycle: the cycle at the end of which the moments are output
+//
+void c_Solver::CalculateMoments(int cycle) {
 
   timeTasks_set_main_task(TimeTasks::MOMENTS);
 
   pad_particle_capacities();
 
+  // pressures of species that neglect them are needed only for output
+  EMf->set_pressure_output(writesFields(cycle));
+
+  // compact particles carry their mesh cell,
+  // so they use their own moment accumulator
+  if(Parameters::get_COMPACT_PCLS())
+  {
+    if(Parameters::get_SORTING_PARTICLES())
+      sortParticles();
+    EMf->setZeroPrimaryMoments();
+    convertParticlesToCompact();
+    EMf->sumMoments_compact(part, grid, vct);
+  }
   // vectorized assumes that particles are sorted by mesh cell
-  if(Parameters::get_VECTORIZE_MOMENTS())
+  else if(Parameters::get_VECTORIZE_MOMENTS())
   {
     switch(Parameters::get_MOMENTS_TYPE())
     {
@@ -255,13 +270,16 @@ void c_Solver::CalculateMoments() {
     switch(Parameters::get_MOMENTS_TYPE())
     {
       case Parameters::SoA:
+        // reads particles in place in either representation
         EMf->setZeroPrimaryMoments();
-        convertParticlesToSoA();
         EMf->sumMoments(part, grid, vct);
         break;
       case Parameters::AoS:
         EMf->setZeroPrimaryMoments();
         convertParticlesToAoS();
+        // complete the cells cached by the mover
+        for (int i = 0; i < ns; i++)
+          part[i].update_pcl_cells();
         EMf->sumMoments_AoS(part, grid, vct);
         break;
       case Parameters::AoSintr:
@@ -269,6 +287,16 @@ void c_Solver::CalculateMoments() {
         convertParticlesToAoS();
         EMf->sumMoments_AoS_intr(part, grid, vct);
         break;
+      case Parameters::AoStiled:
+        // particles were sorted by mesh cell above
+        EMf->setZeroPrimaryMoments();
+        EMf->sumMoments_tiled(part, grid, vct);
+        break;
+      case Parameters::AoScolored:
+        // particles were sorted by mesh cell above
+        EMf->setZeroPrimaryMoments();
+        EMf->sumMoments_colored(part, grid, vct);
+        break;
       default:
         unsupported_value_error(Parameters::get_MOMENTS_TYPE());
     }
@@ -278,7 +306,10 @@ void c_Solver::CalculateMoments() {
   //  EMf->sumMomentsOld(part[i], grid, vct);
   //}
   EMf->setZeroDerivedMoments();
-  EMf->sumOverSpecies(vct);                 // sum all over the species
+  // communicate ghost moments, overlapped with the sum over
+  // species, the interpolation of densities on centers from
+  // nodes and the divergence of the pressures for the hat functions
+  EMf->communicateGhostP2G_overlapped(grid, vct);
 
   // Fill with constant charge the planet
   if (col->getCase()=="Dipole") {
@@ -289,7 +320,6 @@ void c_Solver::CalculateMoments() {
 
   former_MPI_Barrier(MPI_COMM_WORLD);
 
-  EMf->interpDensitiesN2C(vct, grid);       // calculate densities on centers from nodes
   EMf->calculateHatFunctions(grid, vct);    // calculate the hat quantities for the implicit method
   former_MPI_Barrier(MPI_COMM_WORLD);
 
@@ -323,15 +353,22 @@ bool c_Solver::ParticlesMover()
 
     pad_particle_capacities();
 
+    const bool moving_in_chunks = Parameters::get_MOVER_CHUNK_SIZE() > 0
+      && !Parameters::get_COMPACT_PCLS()
+      && Parameters::get_MOVER_TYPE()==Parameters::AoS;
     #pragma omp parallel
     {
-    for (int i = 0; i < ns; i++)  // move each species
+    if(moving_in_chunks)
+      Particles3D::mover_PC_AoS_in_chunks(part, ns, EMf);
+    else for (int i = 0; i < ns; i++)  // move each species
     {
       // #pragma omp task inout(part[i]) in(grid) target_device(booster)
       //
       // should merely pass EMf->get_fieldForPcls() rather than EMf.
       // use the Predictor Corrector scheme to move particles
-      switch(Parameters::get_MOVER_TYPE())
+      if(Parameters::get_COMPACT_PCLS())
+        part[i].mover_PC_compact(EMf);
+      else switch(Parameters::get_MOVER_TYPE())
       {
         case Parameters::SoA:
           part[i].mover_PC(EMf);
@@ -354,16 +391,20 @@ bool c_Solver::ParticlesMover()
         default:
           unsupported_value_error(Parameters::get_MOVER_TYPE());
       }
-      // overlap initial communication of electrons with moving of ions
-      #pragma omp master
-      part[i].separate_and_send_particles();
     }
-    }
-    for (int i = 0; i < ns; i++)  // communicate each species
+    // The movers end without a barrier, so each thread proceeds
+    // directly from its share of one species to its share of the
+    // next rather than waiting at species boundaries; the master
+    // thread meanwhile sends its own emigrants as it finds them.
+    //
+    for (int i = 0; i < ns; i++)
     {
-      //part[i].communicate_particles();
-      part[i].recommunicate_particles_until_done(1);
+      // all threads help separate emigrants; the master sends them
+      part[i].separate_and_send_particles();
     }
+    }
+    // communicate all species
+    Particles3Dcomm::recommunicate_species_until_done(part, ns, 1);
   }
 
   /* -------------------------------------- */
@@ -386,13 +427,28 @@ bool c_Solver::ParticlesMover()
   return (false);
 }
 
+// merge and split particles to bound the number of particles
+// per cell (and therefore the cost of the mover)
+//
+void c_Solver::ResampleParticles(int cycle)
+{
+  const int resample_cycle = Parameters::get_RESAMPLE_CYCLE();
+  if(resample_cycle <= 0 || cycle % resample_cycle != 0)
+    return;
+
+  timeTasks_set_main_task(TimeTasks::PARTICLES);
+  for (int i = 0; i < ns; i++)
+    part[i].resample_particles();
+}
+
 void c_Solver::WriteRestart(int cycle)
 {
   bool do_WriteRestart = (cycle % restart_cycle == 0 && cycle != first_cycle);
   if(!do_WriteRestart)
     return;
 
-  convertParticlesToSynched(); // hack
+  // output reads particles in place
+  convertParticlesToAoS();
   // write the RESTART file
   writeRESTART(RestartDirName, myrank, cycle, ns, vct, col, grid, EMf, part, 0); // without ,0 add to restart file
 }
@@ -468,8 +524,12 @@ void c_Solver::WriteVirtualSatelliteTraces()
   my_file.close();
 }
 
+bool c_Solver::writesFields(int cycle) {
+  return cycle % (col->getFieldOutputCycle()) == 0 || cycle == first_cycle;
+}
+
 void c_Solver::WriteFields(int cycle) {
-  if(cycle % (col->getFieldOutputCycle()) == 0 || cycle == first_cycle)
+  if(writesFields(cycle))
   {
     if (col->getWriteMethod() == "Parallel") {
         WriteOutputParallel(grid, EMf, col, vct, cycle);
@@ -492,8 +552,8 @@ void c_Solver::WriteParticles(int cycle)
   if(!do_WriteParticles)
     return;
 
-  // this is a hack
-  convertParticlesToSynched();
+  // output reads particles in place
+  convertParticlesToAoS();
 
   if (col->getWriteMethod() == "Parallel")
   {
@@ -535,7 +595,7 @@ void c_Solver::WriteOutput(int cycle) {
 void c_Solver::Finalize() {
   if (col->getCallFinalize())
   {
-    convertParticlesToSynched();
+    convertParticlesToAoS();
     writeRESTART(RestartDirName, myrank, (col->getNcycles() + first_cycle) - 1, ns, vct, col, grid, EMf, part, 0);
   }
 
@@ -569,6 +629,13 @@ void c_Solver::convertParticlesToAoS()
     part[i].convertParticlesToAoS();
 }
 
+// convert particle to compact array of structs (used in computing)
+void c_Solver::convertParticlesToCompact()
+{
+  for (int i = 0; i < ns; i++)
+    part[i].convertParticlesToCompact();
+}
+
 // convert particle to array of structs (used in computing)
 void c_Solver::convertParticlesToSynched()
 {
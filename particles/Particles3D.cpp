@@ -23,6 +23,8 @@ developers: Stefano Markidis, Giovanni Lapenta
 #include "MPIdata.h"
 #include "ipicdefs.h"
 #include "TimeTasks.h"
+#include "Parameters.h"
+#include "philox.h"
 
 #include "Particles3D.h"
 
@@ -181,6 +183,12 @@ void Particles3D::maxwellianWithPerturbation(Field * EMf)
 		cout << "------------------------------------------" << endl;
 	}
 
+  if(Parameters::get_COUNTER_BASED_RNG())
+  {
+    maxwellian_in_parallel(EMf, true);
+    return;
+  }
+
   /* initialize random generator with different seed on different processor */
   srand(vct->getCartesian_rank() + 2);
 
@@ -234,9 +242,82 @@ void Particles3D::maxwellianWithPerturbation(Field * EMf)
   print_pcls(_pcls,ns,id_list, num_ids);
 }
 
+// key of the counter-based random stream of particles of
+// species ns in this process, where stream 0 is used for
+// initialization and stream n for the nth repopulation.
+//
+static inline uint32_t pcl_rng_key(int ns, int stream)
+{
+  return uint32_t(ns) + 256u*uint32_t(stream);
+}
+
+// Version of maxwellian() that fills the cells in parallel.
+// The random numbers of each particle are drawn from a stream
+// of a counter-based generator keyed by process and species and
+// indexed by cell and particle, and each particle is written to
+// the position in the list determined by its cell, so the result
+// is the same for any number of threads.
+//
+void Particles3D::maxwellian_in_parallel(Field * EMf, bool perturb_vy)
+{
+  assert_eq(_pcls.size(),0);
+
+  const double q_sgn = (qom / fabs(qom));
+  // multipled by charge density gives charge per particle
+  const double q_factor =  q_sgn * grid->getVOL() / npcel;
+
+  const int nxc = grid->getNXC();
+  const int nyc = grid->getNYC();
+  const int nzc = grid->getNZC();
+  const int num_cells = (nxc-2)*(nyc-2)*(nzc-2);
+  const int nop = num_cells*npcel;
+  _pcls.resize(nop);
+  const double first_ID = pclIDgenerator.generateIDs(nop);
+  const uint32_t key0 = vct->getCartesian_rank();
+  const uint32_t key1 = pcl_rng_key(ns, 0);
+
+  #pragma omp parallel for schedule(static)
+  for (int i = 1; i < nxc - 1; i++)
+  for (int j = 1; j < nyc - 1; j++)
+  for (int k = 1; k < nzc - 1; k++)
+  {
+    const double q = q_factor * EMf->getRHOcs(i, j, k, ns);
+    const int cell = ((i-1)*(nyc-2) + (j-1))*(nzc-2) + (k-1);
+    int pidx = cell*npcel;
+    int ip = 0;
+    for (int ii = 0; ii < npcelx; ii++)
+    for (int jj = 0; jj < npcely; jj++)
+    for (int kk = 0; kk < npcelz; kk++, ip++, pidx++)
+    {
+      PhiloxStream rng(key0, key1, i, j, k, 256u*ip);
+      double u,v,w;
+      rng.sample_maxwellian(
+        u,v,w,
+        uth, vth, wth,
+        u0, v0, w0);
+      const double x = (ii + .5) * (dx / npcelx) + grid->getXN(i, j, k);
+      const double y = (jj + .5) * (dy / npcely) + grid->getYN(i, j, k);
+      const double z = (kk + .5) * (dz / npcelz) + grid->getZN(i, j, k);
+      //add perturbation on Vy (as in maxwellianWithPerturbation)
+      if(perturb_vy && ns==0) v = v + 1e-2*sin(2*M_PI/Lx*x*8);
+      _pcls[pidx].set(u,v,w,q,x,y,z,first_ID+pidx);
+    }
+  }
+  dprintf("number of particles of species %d: %d", ns, getNOP());
+  const int num_ids = 1;
+  longid id_list[num_ids] = {0};
+  print_pcls(_pcls,ns,id_list, num_ids);
+}
+
 /** Maxellian random velocity and uniform spatial distribution */
 void Particles3D::maxwellian(Field * EMf)
 {
+  if(Parameters::get_COUNTER_BASED_RNG())
+  {
+    maxwellian_in_parallel(EMf, false);
+    return;
+  }
+
   /* initialize random generator with different seed on different processor */
   srand(vct->getCartesian_rank() + 2);
 
@@ -340,17 +421,20 @@ void Particles3D::mover_explicit(Field * EMf) {
 }
 /** mover with a Predictor-Corrector scheme */
 void Particles3D::mover_PC(Field * EMf) {
-  convertParticlesToSoA();
+  // the particle accessors used below read and write the AoS list
+  convertParticlesToAoS();
   #pragma omp master
   if (vct->getCartesian_rank() == 0) {
     cout << "*** PC - MOVER species " << ns << " ***" << NiterMover << " ITERATIONS   ****" << endl;
   }
   const_arr4_double fieldForPcls = EMf->get_fieldForPcls();
 
+  begin_emitting_emigrants();
+  const int thread_num = omp_get_thread_num();
   #pragma omp master
   { timeTasks_begin_task(TimeTasks::MOVER_PCL_MOVING); }
   const double dto2 = .5 * dt, qdto2mc = qom * dto2 / c;
-  #pragma omp for schedule(static)
+  #pragma omp for schedule(static) nowait
   // why does single precision make no difference in execution speed?
   //#pragma simd vectorlength(VECTOR_WIDTH)
   for (int pidx = 0; pidx < getNOP(); pidx++) {
@@ -473,11 +557,89 @@ void Particles3D::mover_PC(Field * EMf) {
     fetchU(pidx) = 2.0 * uavg - uorig;
     fetchV(pidx) = 2.0 * vavg - vorig;
     fetchW(pidx) = 2.0 * wavg - worig;
+    emit_if_emigrant(_pcls[pidx], pidx, thread_num);
   }                             // END OF ALL THE PARTICLES
   #pragma omp master
   { timeTasks_end_task(TimeTasks::MOVER_PCL_MOVING); }
 }
 
+// push one particle with the predictor-corrector scheme
+// (the body of the loop of mover_PC_AoS())
+//
+inline void Particles3D::push_pcl_AoS(SpeciesParticle* pcl,
+  const_arr4_pfloat& fieldForPcls, double dto2, double qdto2mc)
+{
+  ALIGNED(pcl);
+  const double xorig = pcl->get_x();
+  const double yorig = pcl->get_y();
+  const double zorig = pcl->get_z();
+  const double uorig = pcl->get_u();
+  const double vorig = pcl->get_v();
+  const double worig = pcl->get_w();
+  double xavg = xorig;
+  double yavg = yorig;
+  double zavg = zorig;
+  double uavg;
+  double vavg;
+  double wavg;
+  // calculate the average velocity iteratively
+  for (int innter = 0; innter < NiterMover; innter++) {
+
+    // compute weights for field components
+    //
+    double weights[8] ALLOC_ALIGNED;
+    int cx,cy,cz;
+    grid->get_safe_cell_and_weights(xavg,yavg,zavg,cx,cy,cz,weights);
+
+    const double* field_components[8] ALLOC_ALIGNED;
+    get_field_components_for_cell(field_components,fieldForPcls,cx,cy,cz);
+
+    double Exl = 0.0;
+    double Eyl = 0.0;
+    double Ezl = 0.0;
+    double Bxl = 0.0;
+    double Byl = 0.0;
+    double Bzl = 0.0;
+    for(int c=0; c<8; c++)
+    {
+      Bxl += weights[c] * field_components[c][0];
+      Byl += weights[c] * field_components[c][1];
+      Bzl += weights[c] * field_components[c][2];
+      Exl += weights[c] * field_components[c][0+DFIELD_3or4];
+      Eyl += weights[c] * field_components[c][1+DFIELD_3or4];
+      Ezl += weights[c] * field_components[c][2+DFIELD_3or4];
+    }
+    const double Omx = qdto2mc*Bxl;
+    const double Omy = qdto2mc*Byl;
+    const double Omz = qdto2mc*Bzl;
+
+    // end interpolation
+    const pfloat omsq = (Omx * Omx + Omy * Omy + Omz * Omz);
+    const pfloat denom = 1.0 / (1.0 + omsq);
+    // solve the position equation
+    const pfloat ut = uorig + qdto2mc * Exl;
+    const pfloat vt = vorig + qdto2mc * Eyl;
+    const pfloat wt = worig + qdto2mc * Ezl;
+    //const pfloat udotb = ut * Bxl + vt * Byl + wt * Bzl;
+    const pfloat udotOm = ut * Omx + vt * Omy + wt * Omz;
+    // solve the velocity equation 
+    uavg = (ut + (vt * Omz - wt * Omy + udotOm * Omx)) * denom;
+    vavg = (vt + (wt * Omx - ut * Omz + udotOm * Omy)) * denom;
+    wavg = (wt + (ut * Omy - vt * Omx + udotOm * Omz)) * denom;
+    // update average position
+    xavg = xorig + uavg * dto2;
+    yavg = yorig + vavg * dto2;
+    zavg = zorig + wavg * dto2;
+  }                           // end of iteration
+  // update the final position and velocity
+  pcl->set_x(xorig + uavg * dt);
+  pcl->set_y(yorig + vavg * dt);
+  pcl->set_z(zorig + wavg * dt);
+  pcl->set_u(2.0 * uavg - uorig);
+  pcl->set_v(2.0 * vavg - vorig);
+  pcl->set_w(2.0 * wavg - worig);
+}
+
 void Particles3D::mover_PC_AoS(Field * EMf)
 {
   convertParticlesToAoS();
@@ -487,20 +649,164 @@ void Particles3D::mover_PC_AoS(Field * EMf)
   }
   const_arr4_pfloat fieldForPcls = EMf->get_fieldForPcls();
 
+  // record the cell where each particle ends up
+  // for the emigrant check, the sort, and the moments
+  const bool caching_cells = Parameters::get_CACHE_PCL_CELLS();
+  begin_emitting_emigrants(caching_cells);
+  if(caching_cells)
+  {
+    #pragma omp barrier
+  }
+  const int thread_num = omp_get_thread_num();
   #pragma omp master
   { timeTasks_begin_task(TimeTasks::MOVER_PCL_MOVING); }
   const double dto2 = .5 * dt, qdto2mc = qom * dto2 / c;
-  #pragma omp for schedule(static)
+  #pragma omp for schedule(static) nowait
   for (int pidx = 0; pidx < getNOP(); pidx++) {
-    // copy the particle
     SpeciesParticle* pcl = &_pcls[pidx];
-    ALIGNED(pcl);
-    const double xorig = pcl->get_x();
-    const double yorig = pcl->get_y();
-    const double zorig = pcl->get_z();
-    const double uorig = pcl->get_u();
-    const double vorig = pcl->get_v();
-    const double worig = pcl->get_w();
+    push_pcl_AoS(pcl, fieldForPcls, dto2, qdto2mc);
+    if(caching_cells)
+    {
+      int* cell = &_pcl_cell[3*pidx];
+      get_pcl_cell(cell, *pcl);
+      emit_if_emigrant(*pcl, cell, pidx, thread_num);
+    }
+    else
+      emit_if_emigrant(*pcl, pidx, thread_num);
+  }                             // END OF ALL THE PARTICLES
+  #pragma omp master
+  { timeTasks_end_task(TimeTasks::MOVER_PCL_MOVING); }
+}
+
+// push the particles of chunk (see begin_emitting_chunks())
+// and list its emigrants
+//
+void Particles3D::push_chunk_AoS(int chunk, int chunk_size,
+  bool caching_cells, const_arr4_pfloat& fieldForPcls)
+{
+  const double dto2 = .5 * dt, qdto2mc = qom * dto2 / c;
+  const int first_pidx = chunk*chunk_size;
+  const int end_pidx = first_pidx+chunk_size < getNOP() ?
+    first_pidx+chunk_size : getNOP();
+  for (int pidx = first_pidx; pidx < end_pidx; pidx++) {
+    SpeciesParticle* pcl = &_pcls[pidx];
+    push_pcl_AoS(pcl, fieldForPcls, dto2, qdto2mc);
+    if(caching_cells)
+    {
+      int* cell = &_pcl_cell[3*pidx];
+      get_pcl_cell(cell, *pcl);
+      list_if_chunk_emigrant(*pcl, cell, pidx, chunk);
+    }
+    else
+      list_if_chunk_emigrant(*pcl, pidx, chunk);
+  }
+  finish_chunk(chunk);
+}
+
+// mover_PC_AoS() for all species at once
+//
+// The particles of every species are split into chunks of
+// MOVER_CHUNK_SIZE particles, and the threads take the next
+// chunk of any species as they become free, so a thread
+// that has finished its share of a light species helps with
+// a heavy one rather than waiting for it.  Whenever the
+// master thread finishes a chunk it sends the emigrants of
+// every chunk pushed so far, so communication proceeds
+// while the remaining chunks are being pushed.
+//
+// Received particles are appended to the lists being
+// pushed, so they are still handled afterward (by
+// separate_and_send_particles(), which must be called for
+// each species, and recommunicate_species_until_done()).
+//
+// This must be called by every thread of the team.
+//
+void Particles3D::mover_PC_AoS_in_chunks(
+  Particles3D* part, int num_species, Field * EMf)
+{
+  const int chunk_size = Parameters::get_MOVER_CHUNK_SIZE();
+  const bool caching_cells = Parameters::get_CACHE_PCL_CELLS();
+  const_arr4_pfloat fieldForPcls = EMf->get_fieldForPcls();
+  for (int is = 0; is < num_species; is++)
+    part[is].convertParticlesToAoS();
+  #pragma omp master
+  {
+    for (int is = 0; is < num_species; is++)
+    {
+      if (part[is].vct->getCartesian_rank() == 0) {
+        cout << "*** PC-AoS - MOVER species " << part[is].ns << " ***"
+          << part[is].NiterMover << " ITERATIONS   ****" << endl;
+      }
+      part[is].begin_emitting_chunks(chunk_size, caching_cells);
+    }
+    timeTasks_begin_task(TimeTasks::MOVER_PCL_MOVING);
+  }
+  #pragma omp barrier
+
+  // number the chunks of all species consecutively
+  int num_chunks = 0;
+  for (int is = 0; is < num_species; is++)
+    num_chunks += part[is].get_num_chunks();
+
+  const bool is_master = (omp_get_thread_num()==0);
+  #pragma omp for schedule(dynamic) nowait
+  for (int i = 0; i < num_chunks; i++)
+  {
+    int is = 0;
+    int chunk = i;
+    while(chunk >= part[is].get_num_chunks())
+      chunk -= part[is++].get_num_chunks();
+    part[is].push_chunk_AoS(chunk, chunk_size, caching_cells, fieldForPcls);
+    if(is_master)
+    {
+      for (int js = 0; js < num_species; js++)
+        part[js].send_emigrants_of_finished_chunks();
+    }
+  }
+  #pragma omp master
+  {
+    // send the emigrants of the chunks that other
+    // threads were still pushing
+    bool all_sent;
+    do
+    {
+      all_sent = true;
+      for (int is = 0; is < num_species; is++)
+        all_sent &= part[is].send_emigrants_of_finished_chunks();
+    }
+    while(!all_sent);
+    timeTasks_end_task(TimeTasks::MOVER_PCL_MOVING);
+  }
+}
+
+// The push is done in double precision;
+// only the stored particle is single precision.
+// Cell and weights of the starting position are available
+// directly from the compact particle, so the first iteration
+// takes them from its cell and offsets in the cell.
+void Particles3D::mover_PC_compact(Field * EMf)
+{
+  convertParticlesToCompact();
+  #pragma omp master
+  if (vct->getCartesian_rank() == 0) {
+    cout << "*** PC-compact - MOVER species " << ns << " ***" << NiterMover << " ITERATIONS   ****" << endl;
+  }
+  const_arr4_pfloat fieldForPcls = EMf->get_fieldForPcls();
+
+  begin_emitting_emigrants();
+  const int thread_num = omp_get_thread_num();
+  #pragma omp master
+  { timeTasks_begin_task(TimeTasks::MOVER_PCL_MOVING); }
+  const double dto2 = .5 * dt, qdto2mc = qom * dto2 / c;
+  #pragma omp for schedule(static) nowait
+  for (int pidx = 0; pidx < getNOP(); pidx++) {
+    // copy the particle
+    SpeciesParticleCompact* cpcl = &_cpcls[pidx];
+    double xorig, yorig, zorig;
+    get_pcl_position(*cpcl, xorig, yorig, zorig);
+    const double uorig = cpcl->get_u();
+    const double vorig = cpcl->get_v();
+    const double worig = cpcl->get_w();
     double xavg = xorig;
     double yavg = yorig;
     double zavg = zorig;
@@ -514,7 +820,21 @@ void Particles3D::mover_PC_AoS(Field * EMf)
       //
       double weights[8] ALLOC_ALIGNED;
       int cx,cy,cz;
-      grid->get_safe_cell_and_weights(xavg,yavg,zavg,cx,cy,cz,weights);
+      if(innter==0)
+      {
+        // the particle starts in the subdomain (or on its edge)
+        cx = cpcl->get_cx();
+        cy = cpcl->get_cy();
+        cz = cpcl->get_cz();
+        grid->assert_cell_coordinates_safe(cx,cy,cz);
+        const double w0x = cpcl->get_dx(0);
+        const double w0y = cpcl->get_dx(1);
+        const double w0z = cpcl->get_dx(2);
+        Grid3DCU::get_weights(weights, w0x, w0y, w0z,
+          1.-w0x, 1.-w0y, 1.-w0z);
+      }
+      else
+        grid->get_safe_cell_and_weights(xavg,yavg,zavg,cx,cy,cz,weights);
 
       const double* field_components[8] ALLOC_ALIGNED;
       get_field_components_for_cell(field_components,fieldForPcls,cx,cy,cz);
@@ -539,14 +859,13 @@ void Particles3D::mover_PC_AoS(Field * EMf)
       const double Omz = qdto2mc*Bzl;
 
       // end interpolation
-      const pfloat omsq = (Omx * Omx + Omy * Omy + Omz * Omz);
-      const pfloat denom = 1.0 / (1.0 + omsq);
+      const double omsq = (Omx * Omx + Omy * Omy + Omz * Omz);
+      const double denom = 1.0 / (1.0 + omsq);
       // solve the position equation
-      const pfloat ut = uorig + qdto2mc * Exl;
-      const pfloat vt = vorig + qdto2mc * Eyl;
-      const pfloat wt = worig + qdto2mc * Ezl;
-      //const pfloat udotb = ut * Bxl + vt * Byl + wt * Bzl;
-      const pfloat udotOm = ut * Omx + vt * Omy + wt * Omz;
+      const double ut = uorig + qdto2mc * Exl;
+      const double vt = vorig + qdto2mc * Eyl;
+      const double wt = worig + qdto2mc * Ezl;
+      const double udotOm = ut * Omx + vt * Omy + wt * Omz;
       // solve the velocity equation 
       uavg = (ut + (vt * Omz - wt * Omy + udotOm * Omx)) * denom;
       vavg = (vt + (wt * Omx - ut * Omz + udotOm * Omy)) * denom;
@@ -557,12 +876,17 @@ void Particles3D::mover_PC_AoS(Field * EMf)
       zavg = zorig + wavg * dto2;
     }                           // end of iteration
     // update the final position and velocity
-    pcl->set_x(xorig + uavg * dt);
-    pcl->set_y(yorig + vavg * dt);
-    pcl->set_z(zorig + wavg * dt);
-    pcl->set_u(2.0 * uavg - uorig);
-    pcl->set_v(2.0 * vavg - vorig);
-    pcl->set_w(2.0 * wavg - worig);
+    SpeciesParticle pcl(
+      2.0 * uavg - uorig,
+      2.0 * vavg - vorig,
+      2.0 * wavg - worig,
+      cpcl->get_q(),
+      xorig + uavg * dt,
+      yorig + vavg * dt,
+      zorig + wavg * dt,
+      0.);
+    pack_pcl(*cpcl, pcl);
+    emit_if_emigrant(pcl, pidx, thread_num);
   }                             // END OF ALL THE PARTICLES
   #pragma omp master
   { timeTasks_end_task(TimeTasks::MOVER_PCL_MOVING); }
@@ -600,6 +924,8 @@ void Particles3D::mover_PC_AoS_vec_intr(Field * EMf)
     cout << "*** PC-AoS-Vec-Intr - MOVER species " << ns << " ***" << NiterMover << " ITERATIONS   ****" << endl;
   }
   const_arr4_pfloat fieldForPcls = EMf->get_fieldForPcls();
+  #pragma omp master
+  _pcl_cell.clear();
 
   SpeciesParticle * pcls = &_pcls[0];
   ALIGNED(pcls);
@@ -609,7 +935,7 @@ void Particles3D::mover_PC_AoS_vec_intr(Field * EMf)
   const double qdto2mc_d = qom * dto2_d / c;
   const F64vec8 dto2 = F64vec8(dto2_d);
   const F64vec8 qdto2mc = F64vec8(qdto2mc_d);
-  #pragma omp for schedule(static)
+  #pragma omp for schedule(static) nowait
   for (int pidx = 0; pidx < getNOP(); pidx+=2)
   {
     // copy the particle
@@ -701,10 +1027,13 @@ void Particles3D::mover_PC_AoS_vec(Field * EMf)
   int needed_capacity = roundup_to_multiple(getNOP(),NUM_PCLS_MOVED_AT_A_TIME);
   assert_le(needed_capacity,_pcls.capacity());
 
+  begin_emitting_emigrants();
+  const int thread_num = omp_get_thread_num();
+  const int nop = getNOP();
   #pragma omp master
   { timeTasks_begin_task(TimeTasks::MOVER_PCL_MOVING); }
   const double dto2 = .5 * dt, qdto2mc = qom * dto2 / c;
-  #pragma omp for schedule(static)
+  #pragma omp for schedule(static) nowait
   for (int pidx = 0; pidx < getNOP(); pidx+=NUM_PCLS_MOVED_AT_A_TIME)
   {
     // copy the particles
@@ -819,6 +1148,11 @@ void Particles3D::mover_PC_AoS_vec(Field * EMf)
       pcl[i]->set_x(j, xorig[i][j] + uavg[i][j] * dt);
       pcl[i]->set_u(j, 2.*uavg[i][j] - uorig[i][j]);
     }
+    // (the last block may include padding)
+    for(int i=0;i<NUM_PCLS_MOVED_AT_A_TIME && pidx+i<nop;i++)
+    {
+      emit_if_emigrant(*pcl[i], pidx+i, thread_num);
+    }
   }
   #pragma omp master
   { timeTasks_end_task(TimeTasks::MOVER_PCL_MOVING); }
@@ -1190,29 +1524,60 @@ int Particles3D::mover_relativistic(Field * EMf)
   return (0);
 }
 
+// writes npcel particles into pcls, with IDs first_ID, first_ID+1, ...
+//
+// The random numbers are drawn from the counter-based stream of
+// the cell for this repopulation (whatever COUNTER_BASED_RNG says),
+// so the cells can be filled by any threads in any order.
+//
 inline void Particles3D::populate_cell_with_particles(
+  SpeciesParticle* pcls, double first_ID,
   int i, int j, int k, double q_per_particle,
   double dx_per_pcl, double dy_per_pcl, double dz_per_pcl)
 {
   const double cell_low_x = grid->getXN(i,j,k);
   const double cell_low_y = grid->getYN(i,j,k);
   const double cell_low_z = grid->getZN(i,j,k);
+  const uint32_t key0 = vct->getCartesian_rank();
+  const uint32_t key1 = pcl_rng_key(ns, num_repopulations);
+  int ip = 0;
   for (int ii=0; ii < npcelx; ii++)
   for (int jj=0; jj < npcely; jj++)
-  for (int kk=0; kk < npcelz; kk++)
+  for (int kk=0; kk < npcelz; kk++, ip++)
   {
-    double u,v,w,q,x,y,z;
-    sample_maxwellian(
+    PhiloxStream rng(key0, key1, i, j, k, 256u*ip);
+    double u,v,w,x,y,z;
+    rng.sample_maxwellian(
       u,v,w,
       uth, vth, wth,
       u0, v0, w0);
-    x = (ii + sample_u_double())*dx_per_pcl + cell_low_x;
-    y = (jj + sample_u_double())*dy_per_pcl + cell_low_y;
-    z = (kk + sample_u_double())*dz_per_pcl + cell_low_z;
-    create_new_particle(u,v,w,q_per_particle,x,y,z);
+    x = (ii + rng.sample_u_double())*dx_per_pcl + cell_low_x;
+    y = (jj + rng.sample_u_double())*dy_per_pcl + cell_low_y;
+    z = (kk + rng.sample_u_double())*dz_per_pcl + cell_low_z;
+    pcls[ip].set(u,v,w,q_per_particle,x,y,z,first_ID+ip);
   }
 }
 
+// the layers of cells whose particles are replaced on repopulation
+// (including the ghost cells beyond them, which are not refilled)
+//
+struct RepopulationLayers
+{
+  // whether the layer at the lower/upper boundary is replaced
+  bool Xleft, Yleft, Zleft, Xrght, Yrght, Zrght;
+  // last cell of the lower layers and first cell of the upper layers
+  int xLow, yLow, zLow, xHgh, yHgh, zHgh;
+  bool contain(int cx, int cy, int cz)const
+  {
+    return (Xleft && cx <= xLow)
+        || (Yleft && cy <= yLow)
+        || (Zleft && cz <= zLow)
+        || (Xrght && cx >= xHgh)
+        || (Yrght && cy >= yHgh)
+        || (Zrght && cz >= zHgh);
+  }
+};
+
 // This could be generalized to use fluid moments
 // to generate particles.
 //
@@ -1256,6 +1621,9 @@ void Particles3D::repopulate_particles()
   if(!do_repopulate)
     return;
 
+  // select a fresh stream of random numbers
+  num_repopulations++;
+
   // there are better ways to obtain these values...
   //
   double  FourPI =16*atan(1.0);
@@ -1266,133 +1634,101 @@ void Particles3D::repopulate_particles()
   const int nyc = grid->getNYC(); const int nzc = grid->getNZC();
   // number of cell layers to repopulate at boundary
   const int num_layers = 3;
-  const double xLow = num_layers*dx;
-  const double yLow = num_layers*dy;
-  const double zLow = num_layers*dz;
-  const double xHgh = Lx-xLow;
-  const double yHgh = Ly-yLow;
-  const double zHgh = Lz-zLow;
   if(repopulateXleft || repopulateXrght) assert_gt(nxc, 2*num_layers);
   if(repopulateYleft || repopulateYrght) assert_gt(nyc, 2*num_layers);
   if(repopulateZleft || repopulateZrght) assert_gt(nzc, 2*num_layers);
 
-  // delete particles in repopulation layers
-  //
-  const int nop_orig = getNOP();
-  int pidx = 0;
-  while(pidx < getNOP())
-  {
-    SpeciesParticle& pcl = _pcls[pidx];
-    // determine whether to delete the particle
-    const bool delete_pcl =
-      (repopulateXleft && pcl.get_x() < xLow) ||
-      (repopulateYleft && pcl.get_y() < yLow) ||
-      (repopulateZleft && pcl.get_z() < zLow) ||
-      (repopulateXrght && pcl.get_x() > xHgh) ||
-      (repopulateYrght && pcl.get_y() > yHgh) ||
-      (repopulateZrght && pcl.get_z() > zHgh);
-    if(delete_pcl)
-      delete_particle(pidx);
-    else
-      pidx++;
-  }
-  const int nop_remaining = getNOP();
-
-  const double dx_per_pcl = dx/npcelx;
-  const double dy_per_pcl = dy/npcely;
-  const double dz_per_pcl = dz/npcelz;
-
   // starting coordinate of upper layer
   const int upXstart = nxc-1-num_layers;
   const int upYstart = nyc-1-num_layers;
   const int upZstart = nzc-1-num_layers;
+  const RepopulationLayers layers = {
+    repopulateXleft, repopulateYleft, repopulateZleft,
+    repopulateXrght, repopulateYrght, repopulateZrght,
+    num_layers, num_layers, num_layers,
+    upXstart, upYstart, upZstart};
+
+  // the particles have moved since they were sorted,
+  // so sort them to find the particles of each cell
+  // (boundary conditions are applied in absolute coordinates)
+  sort_particles_serial_AoS();
+  const int nop_orig = getNOP();
 
-  // inject new particles.
+  // place the particles of each cell in the new list.
+  //
+  // The particles of a layer cell are replaced by npcel new
+  // particles and the particles of other cells are kept, so the
+  // particles of every cell have a known place in the new list
+  // (which is still sorted by cell) and the cells can be handled
+  // in parallel.
   //
+  const int num_cells = nxc*nyc*nzc;
+  vector_int new_offset(num_cells+1);
+  // number of new particles in preceding cells
+  vector_int num_created_before(num_cells);
+  int nop_final = 0;
+  int nop_created = 0;
+  for (int cx=0; cx<nxc; cx++)
+  for (int cy=0; cy<nyc; cy++)
+  for (int cz=0; cz<nzc; cz++)
   {
-    // we shrink the imagined boundaries of the array as we go along to ensure
-    // that we never inject particles twice in a single mesh cell.
-    //
-    // initialize imagined boundaries to full subdomain excluding ghost cells.
-    //
-    int xbeg = 1;
-    int xend = nxc-2;
-    int ybeg = 1;
-    int yend = nyc-2;
-    int zbeg = 1;
-    int zend = nzc-2;
-    if (repopulateXleft)
-    {
-      for (int i=1; i<= num_layers; i++)
-      for (int j=ybeg; j<=yend; j++)
-      for (int k=zbeg; k<=zend; k++)
-      {
-        populate_cell_with_particles(i,j,k,q_per_particle,
-          dx_per_pcl, dy_per_pcl, dz_per_pcl);
-      }
-      // these have all been filled, so never touch them again.
-      xbeg += num_layers;
-    }
-    if (repopulateXrght)
+    const int c = (cx*nyc+cy)*nzc+cz;
+    new_offset[c] = nop_final;
+    num_created_before[c] = nop_created;
+    if(!layers.contain(cx,cy,cz))
+      nop_final += get_numpcls_in_bucket(cx,cy,cz);
+    else if(cx>0 && cy>0 && cz>0 && cx<nxc-1 && cy<nyc-1 && cz<nzc-1)
     {
-      for (int i=upXstart; i<=xend; i++)
-      for (int j=ybeg; j<=yend; j++)
-      for (int k=zbeg; k<=zend; k++)
-      {
-        populate_cell_with_particles(i,j,k,q_per_particle,
-          dx_per_pcl, dy_per_pcl, dz_per_pcl);
-      }
-      // these have all been filled, so never touch them again.
-      xend -= num_layers;
+      nop_final += npcel;
+      nop_created += npcel;
     }
-    if (repopulateYleft)
-    {
-      for (int i=xbeg; i<=xend; i++)
-      for (int j=1; j<=num_layers; j++)
-      for (int k=zbeg; k<=zend; k++)
-      {
-        populate_cell_with_particles(i,j,k,q_per_particle,
-          dx_per_pcl, dy_per_pcl, dz_per_pcl);
-      }
-      // these have all been filled, so never touch them again.
-      ybeg += num_layers;
-    }
-    if (repopulateYrght)
-    {
-      for (int i=xbeg; i<=xend; i++)
-      for (int j=upYstart; j<=yend; j++)
-      for (int k=zbeg; k<=zend; k++)
-      {
-        populate_cell_with_particles(i,j,k,q_per_particle,
-          dx_per_pcl, dy_per_pcl, dz_per_pcl);
-      }
-      // these have all been filled, so never touch them again.
-      yend -= num_layers;
-    }
-    if (repopulateZleft)
+  }
+  new_offset[num_cells] = nop_final;
+
+  // delete particles in repopulation layers and inject new ones
+  //
+  const double dx_per_pcl = dx/npcelx;
+  const double dy_per_pcl = dy/npcely;
+  const double dz_per_pcl = dz/npcelz;
+  const double first_ID = pclIDgenerator.generateIDs(nop_created);
+  _pclstmp.resize(nop_final);
+  #pragma omp parallel for schedule(static)
+  for (int c=0; c<num_cells; c++)
+  {
+    const int np = new_offset[c+1]-new_offset[c];
+    if(!np)
+      continue;
+    const int cx = c/(nyc*nzc);
+    const int cy = (c/nzc)%nyc;
+    const int cz = c%nzc;
+    SpeciesParticle* pcls = &_pclstmp[new_offset[c]];
+    if(layers.contain(cx,cy,cz))
     {
-      for (int i=xbeg; i<=xend; i++)
-      for (int j=ybeg; j<=yend; j++)
-      for (int k=1; k<=num_layers; k++)
-      {
-        populate_cell_with_particles(i,j,k,q_per_particle,
-          dx_per_pcl, dy_per_pcl, dz_per_pcl);
-      }
+      populate_cell_with_particles(
+        pcls, first_ID + num_created_before[c],
+        cx,cy,cz, q_per_particle,
+        dx_per_pcl, dy_per_pcl, dz_per_pcl);
     }
-    if (repopulateZrght)
+    else
     {
-      for (int i=xbeg; i<=xend; i++)
-      for (int j=ybeg; j<=yend; j++)
-      for (int k=upZstart; k<=zend; k++)
-      {
-        populate_cell_with_particles(i,j,k,q_per_particle,
-          dx_per_pcl, dy_per_pcl, dz_per_pcl);
-      }
+      const int offset = get_bucket_offset(cx,cy,cz);
+      for (int ip=0; ip<np; ip++)
+        pcls[ip] = _pcls[offset+ip];
     }
   }
-  const int nop_final = getNOP();
-  const int nop_deleted = nop_orig - nop_remaining;
-  const int nop_created = nop_final - nop_remaining;
+  _pcls.swap(_pclstmp);
+  _pcl_cell.clear();
+  // the buckets now index the new list
+  for (int cx=0; cx<nxc; cx++)
+  for (int cy=0; cy<nyc; cy++)
+  for (int cz=0; cz<nzc; cz++)
+  {
+    const int c = (cx*nyc+cy)*nzc+cz;
+    (*bucket_offset)[cx][cy][cz] = new_offset[c];
+    (*numpcls_in_bucket)[cx][cy][cz] = new_offset[c+1]-new_offset[c];
+  }
+
+  const int nop_deleted = nop_orig + nop_created - nop_final;
 
   dprintf("change in # particles: %d - %d + %d = %d",
     nop_orig, nop_deleted, nop_created, nop_final);
@@ -1583,6 +1919,7 @@ void Particles3D::RotatePlaneXY(double theta) {
 /*! Delete the particles inside the sphere with radius R and center x_center y_center and return the total charge removed */
 double Particles3D::deleteParticlesInsideSphere(double R, double x_center, double y_center, double z_center)
 {
+  convertParticlesToAoS();
   int pidx = 0;
   double Q_removed=0.;
   while (pidx < _pcls.size())
@@ -1602,3 +1939,227 @@ double Particles3D::deleteParticlesInsideSphere(double R, double x_center, doubl
   return(Q_removed);
 }
 
+
+// Replace the n particles with indices pidx by two particles
+// which together have the same charge, momentum, and kinetic
+// energy.  Both particles have half the charge of the group and
+// are placed at its center of charge; their velocities are
+// u +/- d, where u is the mean velocity of the group and |d|^2
+// is its velocity variance.  d points toward the velocity
+// of the particle that lies farthest from u.
+//
+void Particles3D::merge_particles(const int* pidx, int n)
+{
+  double q_sum = 0.;
+  double x_avg[3] = {0., 0., 0.};
+  double u_avg[3] = {0., 0., 0.};
+  double uu_avg = 0.;
+  for(int i=0;i<n;i++)
+  {
+    const SpeciesParticle& pcl = _pcls[pidx[i]];
+    const double q = pcl.get_q();
+    q_sum += q;
+    for(int d=0;d<3;d++)
+    {
+      x_avg[d] += q*pcl.get_x(d);
+      u_avg[d] += q*pcl.get_u(d);
+      uu_avg += q*pcl.get_u(d)*pcl.get_u(d);
+    }
+  }
+  // particles without charge have nothing to conserve
+  if(q_sum == 0.)
+  {
+    for(int i=0;i<n;i++)
+      _pclstmp.push_back(_pcls[pidx[i]]);
+    return;
+  }
+  // all particles of a species have the same sign of charge,
+  // so q/q_sum is a positive weight.
+  const double inv_q_sum = 1./q_sum;
+  double u_sqr = 0.;
+  for(int d=0;d<3;d++)
+  {
+    x_avg[d] *= inv_q_sum;
+    u_avg[d] *= inv_q_sum;
+    u_sqr += u_avg[d]*u_avg[d];
+  }
+  uu_avg *= inv_q_sum;
+  const double variance = uu_avg > u_sqr ? uu_avg - u_sqr : 0.;
+
+  // direction of the spread of the new velocities
+  double dev[3] = {0., 0., 0.};
+  double max_dev_sqr = 0.;
+  for(int i=0;i<n;i++)
+  {
+    const SpeciesParticle& pcl = _pcls[pidx[i]];
+    double dev_i[3];
+    double dev_sqr = 0.;
+    for(int d=0;d<3;d++)
+    {
+      dev_i[d] = pcl.get_u(d) - u_avg[d];
+      dev_sqr += dev_i[d]*dev_i[d];
+    }
+    if(dev_sqr > max_dev_sqr)
+    {
+      max_dev_sqr = dev_sqr;
+      for(int d=0;d<3;d++) dev[d] = dev_i[d];
+    }
+  }
+  const double scale = max_dev_sqr > 0. ? sqrt(variance/max_dev_sqr) : 0.;
+  for(int d=0;d<3;d++) dev[d] *= scale;
+
+  const double q_half = 0.5*q_sum;
+  for(int sgn=-1;sgn<=1;sgn+=2)
+  {
+    _pclstmp.push_back(SpeciesParticle(
+      u_avg[0]+sgn*dev[0], u_avg[1]+sgn*dev[1], u_avg[2]+sgn*dev[2],
+      q_half, x_avg[0], x_avg[1], x_avg[2],
+      pclIDgenerator.generateID()));
+  }
+}
+
+// Replace a particle in cell (cx,cy,cz) by two particles with half
+// its charge and the same velocity, displaced symmetrically about
+// its position so that both remain in the cell.  This conserves
+// charge, momentum, kinetic energy, and center of charge.
+//
+void Particles3D::split_particle(const SpeciesParticle& pcl,
+  int cx, int cy, int cz)
+{
+  const double cell_low[3] = {grid->getXN(cx), grid->getYN(cy), grid->getZN(cz)};
+  const double cell_len[3] = {dx, dy, dz};
+  double disp[3];
+  for(int d=0;d<3;d++)
+  {
+    const double x = pcl.get_x(d);
+    const double lo_dist = x - cell_low[d];
+    const double hi_dist = cell_low[d] + cell_len[d] - x;
+    disp[d] = 0.5*(lo_dist < hi_dist ? lo_dist : hi_dist);
+    if(disp[d] < 0.) disp[d] = 0.;
+    // vary the orientation of the displacement
+    if(sample_u_double() < .5) disp[d] = -disp[d];
+  }
+  const double q_half = 0.5*pcl.get_q();
+  for(int sgn=-1;sgn<=1;sgn+=2)
+  {
+    _pclstmp.push_back(SpeciesParticle(
+      pcl.get_u(), pcl.get_v(), pcl.get_w(), q_half,
+      pcl.get_x()+sgn*disp[0],
+      pcl.get_y()+sgn*disp[1],
+      pcl.get_z()+sgn*disp[2],
+      pclIDgenerator.generateID()));
+  }
+}
+
+// Resample the particles of each cell so that the number of
+// particles per cell stays within a factor of two of npcel
+// (which open boundaries and the dipole sphere do not maintain).
+//
+// In a cell with more than 2*npcel particles, the particles are
+// binned by the octant of their velocity relative to the mean
+// velocity of the cell, and each group of group_size particles
+// in a bin is merged into two particles (see merge_particles()).
+// In a cell with fewer than npcel/2 particles, the heaviest
+// particles are split in two (see split_particle()).
+// Charge, momentum, and energy are conserved in each cell.
+//
+// Particle IDs are not preserved, so species with tracked
+// particles are not resampled.
+//
+void Particles3D::resample_particles()
+{
+  if(TrackParticleID)
+    return;
+
+  const int max_pcls_per_cell = 2*npcel;
+  const int min_pcls_per_cell = npcel/2;
+
+  // sort the particles by cell
+  sort_particles_serial_AoS();
+
+  const int nop_orig = getNOP();
+  _pclstmp.clear();
+  _pclstmp.reserve(nop_orig);
+  // indices of the particles of a cell in each velocity octant
+  vector_int octant[8];
+  // indices of the particles of a cell sorted by charge
+  vector_int by_charge;
+  for(int cx=0;cx<nxc;cx++)
+  for(int cy=0;cy<nyc;cy++)
+  for(int cz=0;cz<nzc;cz++)
+  {
+    const int np = get_numpcls_in_bucket(cx,cy,cz);
+    const int offset = get_bucket_offset(cx,cy,cz);
+    // particles should not remain in ghost cells,
+    // but leave them alone if they do
+    const bool interior = cx>0 && cy>0 && cz>0
+      && cx<nxc-1 && cy<nyc-1 && cz<nzc-1;
+    if(interior && np > max_pcls_per_cell)
+    {
+      double u_avg[3] = {0., 0., 0.};
+      for(int pidx=offset;pidx<offset+np;pidx++)
+      for(int d=0;d<3;d++)
+        u_avg[d] += _pcls[pidx].get_u(d);
+      for(int d=0;d<3;d++)
+        u_avg[d] /= np;
+      for(int o=0;o<8;o++)
+        octant[o].clear();
+      for(int pidx=offset;pidx<offset+np;pidx++)
+      {
+        const SpeciesParticle& pcl = _pcls[pidx];
+        const int o = (pcl.get_u() > u_avg[0] ? 1 : 0)
+                    | (pcl.get_v() > u_avg[1] ? 2 : 0)
+                    | (pcl.get_w() > u_avg[2] ? 4 : 0);
+        octant[o].push_back(pidx);
+      }
+      // merging groups of group_size particles into pairs
+      // leaves about npcel particles in the cell
+      int group_size = (2*np+npcel-1)/npcel;
+      if(group_size < 3) group_size = 3;
+      for(int o=0;o<8;o++)
+      {
+        const int m = octant[o].size();
+        for(int start=0;start<m;start+=group_size)
+        {
+          const int n = m-start < group_size ? m-start : group_size;
+          if(n >= 3)
+            merge_particles(&octant[o][start], n);
+          else for(int i=start;i<m;i++)
+            _pclstmp.push_back(_pcls[octant[o][i]]);
+        }
+      }
+    }
+    else if(interior && np > 0 && np < min_pcls_per_cell)
+    {
+      // select the heaviest particles to split
+      const int num_to_split = min_pcls_per_cell-np < np ?
+        min_pcls_per_cell-np : np;
+      by_charge.clear();
+      for(int pidx=offset;pidx<offset+np;pidx++)
+        by_charge.push_back(pidx);
+      for(int i=0;i<num_to_split;i++)
+      {
+        int heaviest = i;
+        for(int j=i+1;j<np;j++)
+          if(fabs(_pcls[by_charge[j]].get_q())
+           > fabs(_pcls[by_charge[heaviest]].get_q()))
+            heaviest = j;
+        const int tmp = by_charge[i];
+        by_charge[i] = by_charge[heaviest];
+        by_charge[heaviest] = tmp;
+        split_particle(_pcls[by_charge[i]], cx, cy, cz);
+      }
+      for(int i=num_to_split;i<np;i++)
+        _pclstmp.push_back(_pcls[by_charge[i]]);
+    }
+    else
+    {
+      for(int pidx=offset;pidx<offset+np;pidx++)
+        _pclstmp.push_back(_pcls[pidx]);
+    }
+  }
+  _pcls.swap(_pclstmp);
+  _pcl_cell.clear();
+  //dprintf("resampled species %d from %d to %d particles",
+  //  ns, nop_orig, getNOP());
+}
@@ -98,6 +98,20 @@ void print_pcls(vector_SpeciesParticle& pcls, int ns, longid* id_list, int num_i
   }
 }
 
+// index of the offset (dx,dy,dz) of a neighbor process,
+// where each component is -1, 0, or 1
+static inline int nbr_offset_index(int dx, int dy, int dz)
+{
+  return (dx+1)+3*(dy+1)+9*(dz+1);
+}
+// tag of messages sent to the neighbor at offset (dx,dy,dz)
+// (distinct from the tags used for face neighbors, so that
+// connections are unique even if a neighbor is repeated)
+static inline int nbr_tag(int dx, int dy, int dz)
+{
+  return Direction::ZUP+1+nbr_offset_index(dx,dy,dz);
+}
+
 /** deallocate particles */
 Particles3Dcomm::~Particles3Dcomm() {
   // extra xavg for sort
@@ -105,6 +119,9 @@ Particles3Dcomm::~Particles3Dcomm() {
   delete numpcls_in_bucket;
   delete numpcls_in_bucket_now;
   delete bucket_offset;
+  delete [] emigrant_idx;
+  delete [] chunk_emigrant_idx;
+  delete [] chunk_done;
 }
 /** constructor for a single species*/
 // was Particles3Dcomm::allocate()
@@ -118,6 +135,7 @@ Particles3Dcomm::Particles3Dcomm(
   vct(vct_),
   grid(grid_),
   pclIDgenerator(),
+  num_repopulations(0),
   particleType(ParticleType::AoS)
 {
   // communicators for particles
@@ -149,6 +167,40 @@ Particles3Dcomm::Particles3Dcomm(
   recvZleft.post_recvs();
   recvZrght.post_recvs();
 
+  // define connections to edge and corner neighbors
+  //
+  direct_exchange = Parameters::get_DIRECT_PCL_EXCHANGE();
+  num_diag_nbrs = 0;
+  for(int i=0;i<27;i++) diag_idx[i] = -1;
+  if(direct_exchange)
+  {
+    // few particles cross an edge or corner,
+    // so smaller blocks are used for these connections
+    const int diag_blocksize = Parameters::get_blockSize()/4;
+    for(int dz=-1;dz<=1;dz++)
+    for(int dy=-1;dy<=1;dy++)
+    for(int dx=-1;dx<=1;dx++)
+    {
+      // face neighbors use the connections above
+      if(abs(dx)+abs(dy)+abs(dz) < 2) continue;
+      const int nbr = vct->getNeighbor(dx,dy,dz);
+      if(nbr==MPI_PROC_NULL) continue;
+      const int k = num_diag_nbrs++;
+      diag_idx[nbr_offset_index(dx,dy,dz)] = k;
+      sendDiag[k].init(Connection(nbr,nbr_tag(dx,dy,dz),mpi_comm),
+        diag_blocksize, Parameters::get_numBlocks());
+      recvDiag[k].init(Connection(nbr,nbr_tag(-dx,-dy,-dz),mpi_comm),
+        diag_blocksize, Parameters::get_numBlocks());
+      recvDiag[k].post_recvs();
+      diag_shift[k][0] = (dx<0 && vct->isPeriodicXlower())
+                      || (dx>0 && vct->isPeriodicXupper());
+      diag_shift[k][1] = (dy<0 && vct->isPeriodicYlower())
+                      || (dy>0 && vct->isPeriodicYupper());
+      diag_shift[k][2] = (dz<0 && vct->isPeriodicZlower())
+                      || (dz>0 && vct->isPeriodicZupper());
+    }
+  }
+
   // info from collectiveIO
   //
   npcel = col->getNpcel(get_species_num());
@@ -266,8 +318,29 @@ Particles3Dcomm::Particles3Dcomm(
   numpcls_in_bucket = new array3_int(nxc,nyc,nzc);
   numpcls_in_bucket_now = new array3_int(nxc,nyc,nzc);
   bucket_offset = new array3_int(nxc,nyc,nzc);
+
+  // per-thread lists for separating emigrating particles
+  //
+  num_emigrant_lists = omp_get_max_threads();
+  emigrant_idx = new vector_int[num_emigrant_lists];
+  emigrants_emitted = false;
+  chunk_emigrant_idx = 0;
+  chunk_done = 0;
+  num_chunks = 0;
+  max_num_chunks = 0;
+  next_chunk_to_send = 0;
   
   assert_eq(sizeof(SpeciesParticle),64);
+  assert_eq(sizeof(SpeciesParticleCompact),32);
+  if(Parameters::get_COMPACT_PCLS())
+  {
+    if(TrackParticleID)
+      eprintf("compact particles do not retain particle IDs");
+    // guarded subgrid plus a margin must fit in packed cell coordinates
+    if(std::max(nxc,std::max(nyc,nzc)) > SpeciesParticleCompact::max_cell()/2)
+      eprintf("subgrid too large for compact particles");
+    _cpcls.reserve(initial_capacity);
+  }
 
   // if RESTART is true initialize the particle in allocate method
   restart = col->getRestart_status();
@@ -375,11 +448,17 @@ Particles3Dcomm::Particles3Dcomm(
 // pad capacities so that aligned vectorization
 // does not result in an array overrun.
 //
-// this should usually be cheap (a no-op)
+// this should usually be cheap (a no-op), since reserve()
+// never shrinks a list and shrink() releases memory only
+// when a list has fallen to a quarter of its capacity.
 //
 void Particles3Dcomm::pad_capacities()
 {
+  _pcls.shrink();
+  _cpcls.shrink();
+  _pclstmp.shrink();
   _pcls.reserve(roundup_to_multiple(_pcls.size(),DVECWIDTH));
+  _cpcls.reserve(roundup_to_multiple(_cpcls.size(),DVECWIDTH));
   u.reserve(roundup_to_multiple(u.size(),DVECWIDTH));
   v.reserve(roundup_to_multiple(v.size(),DVECWIDTH));
   w.reserve(roundup_to_multiple(w.size(),DVECWIDTH));
@@ -392,6 +471,7 @@ void Particles3Dcomm::pad_capacities()
 
 void Particles3Dcomm::resize_AoS(int nop)
 {
+  _pcl_cell.clear();
   const int padded_nop = roundup_to_multiple(nop,DVECWIDTH);
   _pcls.reserve(padded_nop);
   _pcls.resize(nop);
@@ -520,6 +600,49 @@ void Particles3Dcomm::resize_SoA(int nop)
 //  EMf->communicateGhostP2G(ns, 0, 0, 0, 0, vct);
 //}
 
+// send a particle directly to the neighbor process (sharing a
+// face, edge, or corner) into whose subdomain it has moved.
+//
+// Offsets across a boundary without a neighbor are dropped;
+// the receiving process lies on the same boundary and applies
+// boundary conditions to incoming particles.
+//
+// returns true if particle was sent.  Sends to edge and corner
+// neighbors are not tallied in count.
+//
+inline bool Particles3Dcomm::send_pcl_directly(
+  SpeciesParticle& pcl, int count[6])
+{
+  int dx = 0, dy = 0, dz = 0;
+  if(pcl.get_x() < xstart) { if(!vct->noXlowerNeighbor()) dx = -1; }
+  else if(pcl.get_x() > xend) { if(!vct->noXupperNeighbor()) dx = 1; }
+  if(pcl.get_y() < ystart) { if(!vct->noYlowerNeighbor()) dy = -1; }
+  else if(pcl.get_y() > yend) { if(!vct->noYupperNeighbor()) dy = 1; }
+  if(pcl.get_z() < zstart) { if(!vct->noZlowerNeighbor()) dz = -1; }
+  else if(pcl.get_z() > zend) { if(!vct->noZupperNeighbor()) dz = 1; }
+
+  switch(abs(dx)+abs(dy)+abs(dz))
+  {
+    case 0:
+      return false;
+    case 1:
+      if(dx<0)      { sendXleft.send(pcl); count[0]++; }
+      else if(dx>0) { sendXrght.send(pcl); count[1]++; }
+      else if(dy<0) { sendYleft.send(pcl); count[2]++; }
+      else if(dy>0) { sendYrght.send(pcl); count[3]++; }
+      else if(dz<0) { sendZleft.send(pcl); count[4]++; }
+      else          { sendZrght.send(pcl); count[5]++; }
+      return true;
+    default:
+    {
+      const int k = diag_idx[nbr_offset_index(dx,dy,dz)];
+      assert_ge(k,0);
+      sendDiag[k].send(pcl);
+      return true;
+    }
+  }
+}
+
 // returns true if particle was sent
 //
 // should vectorize this by comparing position vectors
@@ -527,6 +650,12 @@ void Particles3Dcomm::resize_SoA(int nop)
 inline bool Particles3Dcomm::send_pcl_to_appropriate_buffer(
   SpeciesParticle& pcl, int count[6])
 {
+  // a particle that has crossed only boundaries
+  // without a neighbor is sent to this process
+  // so that boundary conditions are applied to it
+  if(direct_exchange && send_pcl_directly(pcl, count))
+    return true;
+
   int was_sent = true;
   // put particle in appropriate communication buffer if exiting
   if(pcl.get_x() < xstart)
@@ -574,6 +703,8 @@ void Particles3Dcomm::flush_send()
   sendYrght.send_complete();
   sendZleft.send_complete();
   sendZrght.send_complete();
+  for(int k=0;k<num_diag_nbrs;k++)
+    sendDiag[k].send_complete();
 }
 
 void Particles3Dcomm::apply_periodic_BC_global(
@@ -935,6 +1066,40 @@ void Particles3Dcomm::apply_BCs_locally(vector_SpeciesParticle& pcl_list,
   }
 }
 
+// apply periodicity shifts to a block of particles
+// received from an edge or corner neighbor
+void Particles3Dcomm::apply_periodic_shifts(
+  vector_SpeciesParticle& pcl_list, const bool shift[3])
+{
+  if(shift[0])
+  {
+    const double Lxinv = 1/Lx;
+    for(int pidx=0;pidx<pcl_list.size();pidx++)
+    {
+      double& x = pcl_list[pidx].fetch_x();
+      x = modulo(x, Lx, Lxinv);
+    }
+  }
+  if(shift[1])
+  {
+    const double Lyinv = 1/Ly;
+    for(int pidx=0;pidx<pcl_list.size();pidx++)
+    {
+      double& y = pcl_list[pidx].fetch_y();
+      y = modulo(y, Ly, Lyinv);
+    }
+  }
+  if(shift[2])
+  {
+    const double Lzinv = 1/Lz;
+    for(int pidx=0;pidx<pcl_list.size();pidx++)
+    {
+      double& z = pcl_list[pidx].fetch_z();
+      z = modulo(z, Lz, Lzinv);
+    }
+  }
+}
+
 namespace PclCommMode
 {
   enum Enum
@@ -954,21 +1119,17 @@ int Particles3Dcomm::handle_received_particles(int pclCommMode)
   using namespace PclCommMode;
   // we expect to receive at least one block from every
   // communicator, so make sure that all receive buffers are
-  // clear and waiting
-  //
-  recvXleft.recv_start(); recvXrght.recv_start();
-  recvYleft.recv_start(); recvYrght.recv_start();
-  recvZleft.recv_start(); recvZrght.recv_start();
-
-  // make sure that current block in each sender is ready for sending
+  // clear and waiting and that the current block in each
+  // sender is ready for sending
   //
-  sendXleft.send_start(); sendXrght.send_start();
-  sendYleft.send_start(); sendYrght.send_start();
-  sendZleft.send_start(); sendZrght.send_start();
+  start_sending_and_receiving();
 
-  const int num_recv_buffers = 6;
+  // six face neighbors followed by any edge and corner neighbors
+  const int max_recv_buffers = 26;
+  const int num_recv_buffers = 6 + num_diag_nbrs;
 
-  int recv_count[6]={0,0,0,0,0,0};
+  int recv_count[max_recv_buffers];
+  for(int i=0;i<num_recv_buffers;i++) recv_count[i]=0;
   int send_count[6]={0,0,0,0,0,0};
   int num_pcls_recved = 0;
   int num_pcls_resent = 0;
@@ -979,40 +1140,36 @@ int Particles3Dcomm::handle_received_particles(int pclCommMode)
   // receive incoming particles, 
   // immediately resending any exiting particles
   //
-  MPI_Request recv_requests[num_recv_buffers] = 
-  {
-    recvXleft.get_curr_request(), recvXrght.get_curr_request(),
-    recvYleft.get_curr_request(), recvYrght.get_curr_request(),
-    recvZleft.get_curr_request(), recvZrght.get_curr_request()
-  };
-  BlockCommunicator<SpeciesParticle>* recvBuffArr[num_recv_buffers] =
+  BlockCommunicator<SpeciesParticle>* recvBuffArr[max_recv_buffers] =
   {
     &recvXleft, &recvXrght,
     &recvYleft, &recvYrght,
     &recvZleft, &recvZrght
   };
+  for(int k=0;k<num_diag_nbrs;k++)
+    recvBuffArr[6+k] = &recvDiag[k];
+  MPI_Request recv_requests[max_recv_buffers];
+  for(int i=0;i<num_recv_buffers;i++)
+  {
+    assert(!recvBuffArr[i]->comm_finished());
+    recv_requests[i] = recvBuffArr[i]->get_curr_request();
+  }
 
-  assert(!recvXleft.comm_finished());
-  assert(!recvXrght.comm_finished());
-  assert(!recvYleft.comm_finished());
-  assert(!recvYrght.comm_finished());
-  assert(!recvZleft.comm_finished());
-  assert(!recvZrght.comm_finished());
-
-  // determine the periodicity shift for each incoming buffer
-  const bool apply_shift[num_recv_buffers] =
+  // determine the periodicity shift for each incoming face buffer
+  // (edge and corner buffers use diag_shift instead)
+  const bool apply_shift[6] =
   {
     vct->isPeriodicXlower(), vct->isPeriodicXupper(),
     vct->isPeriodicYlower(), vct->isPeriodicYupper(),
     vct->isPeriodicZlower(), vct->isPeriodicZupper()
   };
-  const bool do_apply_BCs[num_recv_buffers] =
+  const bool do_apply_BCs[6] =
   {
     vct->noXlowerNeighbor(), vct->noXupperNeighbor(),
     vct->noYlowerNeighbor(), vct->noYupperNeighbor(),
     vct->noZlowerNeighbor(), vct->noZupperNeighbor()
   };
-  const int direction[num_recv_buffers] =
+  const int direction[6] =
   {
     Direction::XDN, Direction::XUP,
     Direction::YDN, Direction::YUP,
@@ -1024,10 +1181,8 @@ int Particles3Dcomm::handle_received_particles(int pclCommMode)
   // while there are still incoming particles
   // put them in the appropriate buffer
   //
-  while(!(
-    recvXleft.comm_finished() && recvXrght.comm_finished() &&
-    recvYleft.comm_finished() && recvYrght.comm_finished() &&
-    recvZleft.comm_finished() && recvZrght.comm_finished()))
+  int num_recvs_finished = 0;
+  while(num_recvs_finished < num_recv_buffers)
   {
     int recv_index;
     MPI_Status recv_status;
@@ -1048,11 +1203,23 @@ int Particles3Dcomm::handle_received_particles(int pclCommMode)
     {
       apply_BCs_globally(pcl_list);
     }
-    else
+    else if(recv_index < 6)
     {
       apply_BCs_locally(pcl_list, direction[recv_index],
         apply_shift[recv_index], do_apply_BCs[recv_index]);
     }
+    else
+    {
+      apply_periodic_shifts(pcl_list, diag_shift[recv_index-6]);
+    }
+    // with direct exchange particles can arrive from any
+    // neighbor outside the domain, so a boundary process applies
+    // boundary conditions to every block that it receives
+    if(direct_exchange && vct->isBoundaryProcess()
+      && !(pclCommMode&do_apply_BCs_globally))
+    {
+      apply_BCs_globally(pcl_list);
+    }
 
     recv_count[recv_index]+=recv_block.size();
     num_pcls_recved += recv_block.size();
@@ -1076,13 +1243,22 @@ int Particles3Dcomm::handle_received_particles(int pclCommMode)
           // The particle belongs here, so put it in the
           // appropriate place. For now, all particles are in a
           // single list, so we append to the list.
-          _pcls.push_back(pcl);
+          if(particleType==ParticleType::compact)
+          {
+            SpeciesParticleCompact cpcl;
+            pack_pcl(cpcl, pcl);
+            _cpcls.push_back(cpcl);
+          }
+          else
+            _pcls.push_back(pcl);
         }
       }
     }
     // release the block and update the receive request
     recvBuff->release_received_block();
     recv_requests[recv_index] = recvBuff->get_curr_request();
+    if(recvBuff->comm_finished())
+      num_recvs_finished++;
   }
 
   if(print_pcl_comm_counts)
@@ -1099,15 +1275,6 @@ int Particles3Dcomm::handle_received_particles(int pclCommMode)
   return num_pcls_resent;
 }
 
-static long long mpi_global_sum(int in)
-{
-  long long total;
-  long long long_in = in;
-  //dprintf("calling MPI_Allreduce(%d,&total,1, ...)", long_in);
-  MPI_Allreduce(&long_in, &total, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
-  return total;
-}
-
 // these methods should be made virtual
 // so that the user can override boundary conditions.
 //
@@ -1327,62 +1494,360 @@ void Particles3Dcomm::apply_Zrght_BC(vector_SpeciesParticle& pcls, int start)
   }
 }
 
-// return number of particles sent
-int Particles3Dcomm::separate_and_send_particles()
+// remove the particles whose indices are listed in sent_idx
+// (in increasing order) from a list of particles
+//
+// Holes below the new end of the list are filled in parallel
+// with the remaining particles at the end of the list, last first,
+// which gives the same result as repeatedly swapping
+// the last particle into each hole.
+//
+// fill_idx: workspace
+//
+template <class Tlist>
+static void remove_sent_particles(Tlist& pcls,
+  const vector_int& sent_idx, vector_int& fill_idx)
 {
-  // why does it happen that multiple particles have an ID of 0?
-  const int num_ids = 1;
-  longid id_list[num_ids] = {0};
-  //print_pcls(_pcls,ns,id_list, num_ids);
-  timeTasks_set_communicating(); // communicating until end of scope
+  const int nop = pcls.size();
+  const int num_sent = sent_idx.size();
+  const int new_nop = nop - num_sent;
+  #pragma omp single
+  {
+    // collect the unsent particles beyond the new end of the list
+    fill_idx.clear();
+    int sidx = num_sent-1;
+    for(int pidx=nop-1; pidx>=new_nop; pidx--)
+    {
+      if(sidx>=0 && sent_idx[sidx]==pidx)
+        sidx--;
+      else
+        fill_idx.push_back(pidx);
+    }
+  }
+  // there is one such particle for each hole below the new end
+  const int num_holes = fill_idx.size();
+  #pragma omp for
+  for(int i=0; i<num_holes; i++)
+  {
+    pcls[sent_idx[i]] = pcls[fill_idx[i]];
+  }
+  #pragma omp single
+  pcls.resize(new_nop);
+}
 
-  convertParticlesToAoS();
+// move the cached cells as remove_sent_particles() moved
+// the particles (cells holds three entries per particle)
+//
+static void remove_sent_pcl_cells(vector_int& cells,
+  const vector_int& sent_idx, const vector_int& fill_idx)
+{
+  const int num_holes = fill_idx.size();
+  #pragma omp for
+  for(int i=0; i<num_holes; i++)
+  {
+    int* hole = &cells[3*sent_idx[i]];
+    const int* fill = &cells[3*fill_idx[i]];
+    hole[0] = fill[0];
+    hole[1] = fill[1];
+    hole[2] = fill[2];
+  }
+  #pragma omp single
+  cells.resize(cells.size()-3*sent_idx.size());
+}
 
-  // activate receiving
-  //
+// activate receiving and make sure that the
+// current block in each sender is ready for sending
+//
+// (called by the master thread)
+//
+void Particles3Dcomm::start_sending_and_receiving()
+{
   recvXleft.recv_start(); recvXrght.recv_start();
   recvYleft.recv_start(); recvYrght.recv_start();
   recvZleft.recv_start(); recvZrght.recv_start();
 
-  // make sure that current block in each sender is ready for sending
-  //
   sendXleft.send_start(); sendXrght.send_start();
   sendYleft.send_start(); sendYrght.send_start();
   sendZleft.send_start(); sendZrght.send_start();
 
+  for(int k=0;k<num_diag_nbrs;k++)
+  {
+    recvDiag[k].recv_start();
+    sendDiag[k].send_start();
+  }
+}
+
+// prepare to send emigrants from within a mover loop
+//
+// This must be called by every thread of the team that
+// executes the (statically scheduled) mover loop, and
+// separate_and_send_particles() must be called afterward.
+//
+// caching_cells: the mover will record the cell of each
+// particle (otherwise any cached cells become invalid);
+// the caller must then wait at a barrier before the loop.
+//
+void Particles3Dcomm::begin_emitting_emigrants(bool caching_cells)
+{
+  #pragma omp master
+  {
+    start_sending_and_receiving();
+    sent_idx.clear();
+    for(int i=0;i<6;i++) emit_count[i]=0;
+    emigrants_emitted = true;
+    if(caching_cells)
+      _pcl_cell.resize(3*_pcls.size());
+    else
+      _pcl_cell.clear();
+  }
+  const int thread_num = omp_get_thread_num();
+  assert_lt(thread_num, num_emigrant_lists);
+  emigrant_idx[thread_num].clear();
+}
+
+// The master thread sends its emigrants immediately, so that
+// blocks are sent as they fill while the push continues.
+// Other threads list their emigrants for the master to send
+// in separate_and_send_particles(), since only the master
+// thread makes MPI calls.  The master thread handles the
+// first chunk of a static schedule, so the sent particles
+// are still listed in order of increasing index.
+//
+void Particles3Dcomm::emit_emigrant(SpeciesParticle& pcl, int pidx, int thread_num)
+{
+  if(thread_num==0)
+  {
+    bool was_sent = send_pcl_to_appropriate_buffer(pcl, emit_count);
+    assert(was_sent);
+    sent_idx.push_back(pidx);
+  }
+  else
+  {
+    emigrant_idx[thread_num].push_back(pidx);
+  }
+}
+
+// prepare to send the emigrants of chunks of particles
+// from within a chunked mover
+//
+// The particles are split into chunks of chunk_size particles,
+// which may be pushed in any order by any threads (see
+// Particles3D::mover_PC_AoS_in_chunks()).  The emigrants of each
+// chunk are listed separately, and the master thread sends them
+// chunk by chunk in order, so the sent particles are still listed
+// in order of increasing index, and separate_and_send_particles()
+// must be called afterward.
+//
+// (called by the master thread; the threads must then wait at a
+// barrier before they push any chunk)
+//
+void Particles3Dcomm::begin_emitting_chunks(int chunk_size, bool caching_cells)
+{
+  assert_gt(chunk_size, 0);
+  start_sending_and_receiving();
+  sent_idx.clear();
+  for(int i=0;i<6;i++) emit_count[i]=0;
+  emigrants_emitted = true;
+  if(caching_cells)
+    _pcl_cell.resize(3*_pcls.size());
+  else
+    _pcl_cell.clear();
+  // no emigrants are left for separate_and_send_particles() to send
+  for(int t=0;t<num_emigrant_lists;t++)
+    emigrant_idx[t].clear();
+
+  num_chunks = (_pcls.size() + chunk_size - 1)/chunk_size;
+  if(num_chunks > max_num_chunks)
+  {
+    delete [] chunk_emigrant_idx;
+    delete [] chunk_done;
+    max_num_chunks = num_chunks;
+    chunk_emigrant_idx = new vector_int[max_num_chunks];
+    chunk_done = new int[max_num_chunks];
+  }
+  for(int c=0;c<num_chunks;c++)
+  {
+    chunk_emigrant_idx[c].clear();
+    chunk_done[c] = 0;
+  }
+  next_chunk_to_send = 0;
+}
+
+// record that chunk has been pushed and its emigrants listed
+// (called by the thread that pushed it)
+//
+void Particles3Dcomm::finish_chunk(int chunk)
+{
+  // publish the list of emigrants before the flag
+  #pragma omp flush
+  #pragma omp atomic write
+  chunk_done[chunk] = 1;
+}
+
+// send the emigrants of the chunks that have been pushed,
+// stopping at the first chunk that is still being pushed;
+// returns true once the emigrants of every chunk are sent
+//
+// (called by the master thread, which alone makes MPI calls)
+//
+bool Particles3Dcomm::send_emigrants_of_finished_chunks()
+{
+  while(next_chunk_to_send < num_chunks)
+  {
+    int done;
+    #pragma omp atomic read
+    done = chunk_done[next_chunk_to_send];
+    if(!done)
+      return false;
+    #pragma omp flush
+    const vector_int& emigrants = chunk_emigrant_idx[next_chunk_to_send];
+    for(int i=0; i<emigrants.size(); i++)
+    {
+      const int pidx = emigrants[i];
+      bool was_sent = send_pcl_to_appropriate_buffer(_pcls[pidx], emit_count);
+      assert(was_sent);
+      sent_idx.push_back(pidx);
+    }
+    next_chunk_to_send++;
+  }
+  return true;
+}
+
+// return number of particles sent
+//
+// This may be called by all the threads of a team (as well as
+// outside of a parallel region).  Threads search for emigrating
+// particles in parallel, and the master thread feeds them to the
+// senders; the holes they leave are then filled in parallel.
+//
+// If the mover has already emitted the emigrants
+// (see emit_emigrant()) the search is skipped.
+//
+int Particles3Dcomm::separate_and_send_particles()
+{
+  timeTasks_set_communicating(); // communicating until end of scope
+
+  // the movers end without a barrier, so wait until
+  // every thread has finished pushing its particles
+  #pragma omp barrier
+  if(particleType!=ParticleType::compact)
+    convertParticlesToAoS();
+  const bool compact = (particleType==ParticleType::compact);
+  const bool emitted = emigrants_emitted;
+
+  if(!emitted)
+  {
+    #pragma omp master
+    start_sending_and_receiving();
+  }
+
+  // each thread lists the candidate emigrants in its
+  // (contiguous) range of particles
+  //
+  const int thread_num = omp_get_thread_num();
+  assert_lt(thread_num, num_emigrant_lists);
+  vector_int& my_emigrant_idx = emigrant_idx[thread_num];
+  if(emitted)
+  {
+    // emigrants were already listed by the mover
+  }
+  else if(compact)
+  {
+    my_emigrant_idx.clear();
+    // only particles outside the proper cells need be expanded
+    const int nop = _cpcls.size();
+    #pragma omp for schedule(static)
+    for(int pidx=0; pidx<nop; pidx++)
+    {
+      if(__builtin_expect(test_outside_subdomain_cells(_cpcls[pidx]),false))
+        my_emigrant_idx.push_back(pidx);
+    }
+  }
+  else if(const int* cells = get_pcl_cells())
+  {
+    my_emigrant_idx.clear();
+    const int nop = _pcls.size();
+    #pragma omp for schedule(static)
+    for(int pidx=0; pidx<nop; pidx++)
+    {
+      if(__builtin_expect(test_outside_subdomain(_pcls[pidx],
+        &cells[3*pidx]),false))
+        my_emigrant_idx.push_back(pidx);
+    }
+  }
+  else
+  {
+    my_emigrant_idx.clear();
+    const int nop = _pcls.size();
+    #pragma omp for schedule(static)
+    for(int pidx=0; pidx<nop; pidx++)
+    {
+      if(__builtin_expect(test_outside_subdomain(_pcls[pidx]),false))
+        my_emigrant_idx.push_back(pidx);
+    }
+  }
+
+  // send the emigrants in order of increasing index
+  //
   int send_count[6]={0,0,0,0,0,0};
-  const int num_pcls_initially = _pcls.size();
-  int np_current = 0;
-  while(np_current < _pcls.size())
-  {
-    SpeciesParticle& pcl = _pcls[np_current];
-    // if the particle is exiting, put it in the appropriate send bin;
-    // this could be done at conclusion of push after particles are
-    // converted to AoS format in order to overlap communication
-    // with computation.
-    bool was_sent = send_pcl_to_appropriate_buffer(pcl,send_count);
-
-    // fill in hole; for the sake of data pipelining could change
-    // this to make a list of holes and then go back and fill
-    // them in, but will builtin_expect also allow efficient
-    // pipelining?  Or does the compiler generate instructions
-    // that automatically adjust pipelining based on
-    // accumulated statistical branching behavior?
-    //
-    // optimizer should assume that most particles are not sent
-    if(__builtin_expect(was_sent,false))
+  #pragma omp master
+  {
+    // the master's own emigrants may already have been sent
+    int first_tidx = 0;
+    if(emitted)
     {
-      //dprintf("sent particle %d", np_current);
-      delete_particle(np_current);
+      for(int i=0;i<6;i++) send_count[i] = emit_count[i];
+      first_tidx = 1;
     }
     else
     {
-      np_current++;
+      sent_idx.clear();
+    }
+    const int num_threads = omp_get_num_threads();
+    for(int tidx=first_tidx; tidx<num_threads; tidx++)
+    {
+      const vector_int& candidates = emigrant_idx[tidx];
+      for(int i=0; i<candidates.size(); i++)
+      {
+        const int pidx = candidates[i];
+        bool was_sent;
+        if(compact)
+        {
+          SpeciesParticle pcl;
+          unpack_pcl(pcl, _cpcls[pidx]);
+          was_sent = send_pcl_to_appropriate_buffer(pcl,send_count);
+        }
+        else
+        {
+          was_sent = send_pcl_to_appropriate_buffer(_pcls[pidx],send_count);
+        }
+        if(was_sent)
+          sent_idx.push_back(pidx);
+      }
     }
   }
-  assert_eq(_pcls.size(),np_current);
-  const int num_pcls_unsent = getNOP();
-  const int num_pcls_sent = num_pcls_initially - num_pcls_unsent;
+  #pragma omp barrier
+  const int num_pcls_sent = sent_idx.size();
+  const bool cells_cached = !compact && get_pcl_cells();
+  #pragma omp master
+  emigrants_emitted = false;
+
+  // fill in the holes left by the emigrants
+  //
+  if(compact)
+    remove_sent_particles(_cpcls, sent_idx, fill_idx);
+  else
+    remove_sent_particles(_pcls, sent_idx, fill_idx);
+  // cached cells move with their particles
+  if(cells_cached)
+    remove_sent_pcl_cells(_pcl_cell, sent_idx, fill_idx);
+  else if(!compact)
+  {
+    #pragma omp single
+    _pcl_cell.clear();
+  }
+
+  #pragma omp master
   if(print_pcl_comm_counts)
   {
     dprintf("spec %d send_count: %d+%d+%d+%d+%d+%d=%d",ns,
@@ -1426,81 +1891,138 @@ int Particles3Dcomm::separate_and_send_particles()
 //   forces
 //   
 void Particles3Dcomm::recommunicate_particles_until_done(int min_num_iterations)
+{
+  recommunicate_species_until_done(this, 1, min_num_iterations);
+}
+
+// start a reduction of the number of particles of each
+// species that were resent by all processes
+//
+static void start_global_sum(const long long* in, long long* total,
+  int num_species, MPI_Request* request)
+{
+  #if MPI_VERSION >= 3
+    MPI_Iallreduce(in, total, num_species, MPI_LONG_LONG, MPI_SUM,
+      MPI_COMM_WORLD, request);
+  #else
+    MPI_Allreduce(in, total, num_species, MPI_LONG_LONG, MPI_SUM,
+      MPI_COMM_WORLD);
+    *request = MPI_REQUEST_NULL;
+  #endif
+}
+
+// recommunicate_particles_until_done() for all species at once
+//
+// Termination is detected with a single reduction per round
+// for all species, and the reduction is overlapped with the
+// following round of communication: if no process resent any
+// particles of a species in a round, then no particles of that
+// species are received in the next round, so the result of
+// the reduction started after a round is not needed until the
+// next round has been completed.  Step (2) of the algorithm
+// is the round that hides the first reduction.
+//
+// As with sumMoments, part is the array of all species.
+//
+// the input file gives values for at most this many species
+// (see input_array.h)
+static const int max_num_species = 6;
+
+void Particles3Dcomm::recommunicate_species_until_done(
+  Particles3Dcomm* part, int num_species, int min_num_iterations)
 {
   timeTasks_set_communicating(); // communicating until end of scope
   assert_gt(min_num_iterations,0);
-  // most likely exactly three particle communications
-  // will be needed, one for each dimension of space,
-  // so we begin with three receives and thereafter
-  // before each receive we do an all-reduce to check
-  // if more particles actually need to be received.
-  //
-  // alternatively, we could monitor how many iterations
-  // are needed and adjust the initial number of iterations
-  // accordingly.  The goals to balance would be
-  // * to minimize the number of all-reduce calls and
-  // * to minimize unnecessary sends,
-  // with the overall goal of minimizing time spent in communication
-  //
-  int num_pcls_sent;
-  for(int i=0;i<min_num_iterations;i++)
+  if(num_species > max_num_species)
+    eprintf("%d species exceed the limit of %d", num_species, max_num_species);
+
+  // number of particles of each species resent
+  // by this process in the latest round
+  long long num_pcls_sent[max_num_species];
+  // send buffer of the reduction, which must not be
+  // modified until the reduction is complete
+  long long num_pcls_sent_to_sum[max_num_species];
+  // number resent by all processes in the preceding round
+  long long total_num_pcls_sent[max_num_species];
+  // whether particles of each species are still being communicated
+  bool active[max_num_species];
+
+  for(int is=0;is<num_species;is++)
   {
-    flush_send(); // flush sending of particles
-    num_pcls_sent = handle_received_particles();
-    //dprintf("spec %d #pcls sent = %d", ns, num_pcls_sent);
+    for(int i=0;i<min_num_iterations;i++)
+    {
+      part[is].flush_send(); // flush sending of particles
+      num_pcls_sent[is] = part[is].handle_received_particles();
+      //dprintf("spec %d #pcls sent = %d", is, num_pcls_sent[is]);
+    }
+    active[is] = true;
   }
 
-  // apply boundary conditions to incoming particles
-  // until they are in the domain
-  flush_send(); // flush sending of particles
-  num_pcls_sent = handle_received_particles(PclCommMode::do_apply_BCs_globally);
-
-  //if(do_apply_periodic_BC_global)
-  //  assert(test_pcls_are_in_domain(_pcls));
-  //else
-  //  assert(test_pcls_are_in_nonperiodic_domain(_pcls));
-
-  // compute how many times particles must be communicated
-  // globally before every particle is in the correct subdomain
-  // (would need to modify handle_received_particles so that it
-  // returns num_comm_needed)
-  //const int global_num_comm_needed = mpi_global_max(num_comm_needed);
-  // once I see that this is anticipating the number of communications
-  // correctly, I will eliminate the total_num_pcls_sent check below
-  //dprint(global_num_comm_needed);
-
-  // continue receiving and resending incoming particles until
-  // global all-reduce of num_pcls_resent is zero, indicating
-  // that there are no more particles to be received.
-  //
-  long long total_num_pcls_sent = mpi_global_sum(num_pcls_sent);
-  if(print_pcl_comm_counts)
-    dprintf("spec %d pcls sent: %d, %d",
-      ns, num_pcls_sent, total_num_pcls_sent);
-
   // the maximum number of neighbor communications that would
   // be needed to put a particle in the correct mesh cell
+  const VirtualTopology3D* vct = part[0].vct;
   int comm_max_times = vct->getXLEN()+vct->getYLEN()+vct->getZLEN();
   if(!do_apply_periodic_BC_global) comm_max_times*=2;
   int comm_count=0;
-  while(total_num_pcls_sent)
+  // with direct exchange, boundary processes already apply
+  // boundary conditions globally to incoming particles
+  int pclCommMode = part[0].direct_exchange ?
+    0 : PclCommMode::do_apply_BCs_globally;
+  // The price of the overlap is one more round than a blocking
+  // reduction would need: the round that learns that nothing was
+  // resent has already exchanged with the neighbors, usually
+  // sending and receiving nothing.  This trades an exchange of
+  // empty messages with the neighbors for the latency of a global
+  // reduction, which grows with the number of processes.
+  for(;;)
   {
+    MPI_Request request;
+    for(int is=0;is<num_species;is++)
+      num_pcls_sent_to_sum[is] = num_pcls_sent[is];
+    start_global_sum(num_pcls_sent_to_sum, total_num_pcls_sent,
+      num_species, &request);
+
+    // communicate the particles resent in the preceding round
+    // while the reduction completes
+    for(int is=0;is<num_species;is++)
+    {
+      num_pcls_sent[is] = 0;
+      if(!active[is]) continue;
+      part[is].flush_send(); // flush sending of particles
+      num_pcls_sent[is] = part[is].handle_received_particles(pclCommMode);
+    }
+    pclCommMode = 0;
+
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+    bool still_active = false;
+    for(int is=0;is<num_species;is++)
+    {
+      if(!active[is]) continue;
+      if(print_pcl_comm_counts)
+        dprintf("spec %d pcls sent: %lld", is, total_num_pcls_sent[is]);
+      if(total_num_pcls_sent[is]==0)
+      {
+        // nothing was received, so nothing was resent
+        assert_eq(num_pcls_sent[is], 0LL);
+        active[is] = false;
+      }
+      else
+        still_active = true;
+    }
+    if(!still_active) break;
+
     if(comm_count>=(comm_max_times))
     {
       dprintf("particles still uncommunicated:");
-      flush_send();
-      num_pcls_sent = handle_received_particles(PclCommMode::print_sent_pcls);
+      for(int is=0;is<num_species;is++)
+      {
+        if(!active[is]) continue;
+        part[is].flush_send();
+        part[is].handle_received_particles(PclCommMode::print_sent_pcls);
+      }
       eprintf("failed to finish up particle communication"
         " within %d communications", comm_max_times);
     }
-
-    // flush sending of particles
-    flush_send();
-    num_pcls_sent = handle_received_particles();
-
-    total_num_pcls_sent = mpi_global_sum(num_pcls_sent);
-    if(print_pcl_comm_counts)
-      dprint(total_num_pcls_sent);
     comm_count++;
   }
 }
@@ -1524,6 +2046,17 @@ void Particles3Dcomm::communicate_particles()
 double Particles3Dcomm::getKe() {
   double localKe = 0.0;
   double totalKe = 0.0;
+  if(particleType==ParticleType::compact)
+  for (int i = 0; i < _cpcls.size(); i++)
+  {
+    const SpeciesParticleCompact& pcl = _cpcls[i];
+    const double u = pcl.get_u();
+    const double v = pcl.get_v();
+    const double w = pcl.get_w();
+    const double q = pcl.get_q();
+    localKe += .5*(q/qom)*(u*u + v*v + w*w);
+  }
+  else
   for (register int i = 0; i < _pcls.size(); i++)
   {
     SpeciesParticle& pcl = _pcls[i];
@@ -1546,6 +2079,17 @@ double Particles3Dcomm::getKe() {
 double Particles3Dcomm::getP() {
   double localP = 0.0;
   double totalP = 0.0;
+  if(particleType==ParticleType::compact)
+  for (int i = 0; i < _cpcls.size(); i++)
+  {
+    const SpeciesParticleCompact& pcl = _cpcls[i];
+    const double u = pcl.get_u();
+    const double v = pcl.get_v();
+    const double w = pcl.get_w();
+    const double q = pcl.get_q();
+    localP += (q/qom)*sqrt(u*u + v*v + w*w);
+  }
+  else
   for (register int i = 0; i < _pcls.size(); i++)
   {
     SpeciesParticle& pcl = _pcls[i];
@@ -1563,6 +2107,16 @@ double Particles3Dcomm::getP() {
 double Particles3Dcomm::getMaxVelocity() {
   double localVel = 0.0;
   double maxVel = 0.0;
+  if(particleType==ParticleType::compact)
+  for (int i = 0; i < _cpcls.size(); i++)
+  {
+    const SpeciesParticleCompact& pcl = _cpcls[i];
+    const double u = pcl.get_u();
+    const double v = pcl.get_v();
+    const double w = pcl.get_w();
+    localVel = std::max(localVel, sqrt(u*u + v*v + w*w));
+  }
+  else
   for (int i = 0; i < _pcls.size(); i++)
   {
     SpeciesParticle& pcl = _pcls[i];
@@ -1661,17 +2215,42 @@ void Particles3Dcomm::sort_particles_serial()
       sort_particles_serial_AoS();
       convertParticlesToSynched();
       break;
+    case ParticleType::compact:
+      sort_particles_serial_AoS();
+      convertParticlesToCompact();
+      break;
     default:
       unsupported_value_error(particleType);
   }
 }
 
+// compute the cached cells of any particles that lack one
+// (e.g. particles received since the push)
+//
+void Particles3Dcomm::update_pcl_cells()
+{
+  if(!Parameters::get_CACHE_PCL_CELLS())
+    return;
+  assert_eq(particleType, ParticleType::AoS);
+  const int nop = _pcls.size();
+  const int num_cached = _pcl_cell.size()/3;
+  _pcl_cell.resize(3*nop);
+  #pragma omp parallel for
+  for(int pidx=num_cached; pidx<nop; pidx++)
+    get_pcl_cell(&_pcl_cell[3*pidx], _pcls[pidx]);
+}
+
 // need to sort and communicate particles after each iteration
 void Particles3Dcomm::sort_particles_serial_AoS()
 {
   convertParticlesToAoS();
+  // cells cached by the mover are permuted with the particles
+  update_pcl_cells();
+  const int* cells = get_pcl_cells();
 
-  _pclstmp.reserve(_pcls.size());
+  _pclstmp.resize(_pcls.size());
+  if(cells)
+    _pcl_celltmp.resize(_pcl_cell.size());
   {
     numpcls_in_bucket->setall(0);
     // iterate through particles and count where they will go
@@ -1680,7 +2259,15 @@ void Particles3Dcomm::sort_particles_serial_AoS()
       const SpeciesParticle& pcl = get_pcl(pidx);
       // get the cell indices of the particle
       int cx,cy,cz;
-      grid->get_safe_cell_coordinates(cx,cy,cz,pcl.get_x(),pcl.get_y(),pcl.get_z());
+      if(cells)
+      {
+        cx = cells[3*pidx];
+        cy = cells[3*pidx+1];
+        cz = cells[3*pidx+2];
+        grid->make_cell_coordinates_safe(cx,cy,cz);
+      }
+      else
+        grid->get_safe_cell_coordinates(cx,cy,cz,pcl.get_x(),pcl.get_y(),pcl.get_z());
 
       // increment the number of particles in bucket of this particle
       (*numpcls_in_bucket)[cx][cy][cz]++;
@@ -1707,7 +2294,15 @@ void Particles3Dcomm::sort_particles_serial_AoS()
       const SpeciesParticle& pcl = get_pcl(pidx);
       // get the cell indices of the particle
       int cx,cy,cz;
-      grid->get_safe_cell_coordinates(cx,cy,cz,pcl.get_x(),pcl.get_y(),pcl.get_z());
+      if(cells)
+      {
+        cx = cells[3*pidx];
+        cy = cells[3*pidx+1];
+        cz = cells[3*pidx+2];
+        grid->make_cell_coordinates_safe(cx,cy,cz);
+      }
+      else
+        grid->get_safe_cell_coordinates(cx,cy,cz,pcl.get_x(),pcl.get_y(),pcl.get_z());
 
       // compute where the data should go
       const int numpcls_now = (*numpcls_in_bucket_now)[cx][cy][cz]++;
@@ -1720,6 +2315,13 @@ void Particles3Dcomm::sort_particles_serial_AoS()
       // copy particle data to new location
       //
       _pclstmp[outpidx] = pcl;
+      if(cells)
+      {
+        int* outcell = &_pcl_celltmp[3*outpidx];
+        outcell[0] = cells[3*pidx];
+        outcell[1] = cells[3*pidx+1];
+        outcell[2] = cells[3*pidx+2];
+      }
     }
     // swap the tmp particle memory with the official particle memory
     {
@@ -1728,6 +2330,8 @@ void Particles3Dcomm::sort_particles_serial_AoS()
       // to swap all the accessors.
       //
       _pcls.swap(_pclstmp);
+      if(cells)
+        _pcl_cell.swap(_pcl_celltmp);
     }
 
     // check if the particles were sorted incorrectly
@@ -1956,6 +2560,84 @@ void Particles3Dcomm::copyParticlesToAoS()
   particleType = ParticleType::synched;
 }
 
+// pack AoS particles into compact representation
+//
+// Afterward the AoS and SoA representations are no longer valid
+// and their memory is released, so that the resident footprint
+// is that of the compact particles alone.
+//
+void Particles3Dcomm::copyParticlesToCompact()
+{
+  timeTasks_set_task(TimeTasks::TRANSPOSE_PCLS_TO_AOS);
+  const int nop = _pcls.size();
+  #pragma omp single
+  {
+    _cpcls.reserve(roundup_to_multiple(nop,DVECWIDTH));
+    _cpcls.resize(nop);
+  }
+  #pragma omp for
+  for(int pidx=0; pidx<nop; pidx++)
+  {
+    pack_pcl(_cpcls[pidx], _pcls[pidx]);
+  }
+  // release memory of other representations
+  #pragma omp single
+  {
+    vector_SpeciesParticle empty_pcls; _pcls.swap(empty_pcls);
+    _pcl_cell.clear();
+    vector_double empty_u; u.swap(empty_u);
+    vector_double empty_v; v.swap(empty_v);
+    vector_double empty_w; w.swap(empty_w);
+    vector_double empty_q; q.swap(empty_q);
+    vector_double empty_x; x.swap(empty_x);
+    vector_double empty_y; y.swap(empty_y);
+    vector_double empty_z; z.swap(empty_z);
+    vector_double empty_t; t.swap(empty_t);
+    particleType = ParticleType::compact;
+  }
+}
+
+// expand compact particles into AoS representation
+//
+void Particles3Dcomm::copyParticlesFromCompact()
+{
+  timeTasks_set_task(TimeTasks::TRANSPOSE_PCLS_TO_AOS);
+  const int nop = _cpcls.size();
+  #pragma omp single
+  resize_AoS(nop);
+  #pragma omp for
+  for(int pidx=0; pidx<nop; pidx++)
+  {
+    unpack_pcl(_pcls[pidx], _cpcls[pidx]);
+  }
+  #pragma omp single
+  {
+    _cpcls.clear();
+    particleType = ParticleType::AoS;
+  }
+}
+
+// defines compact to be the authority
+//
+void Particles3Dcomm::convertParticlesToCompact()
+{
+  switch(particleType)
+  {
+    default:
+      unsupported_value_error(particleType);
+    case ParticleType::SoA:
+      copyParticlesToAoS();
+      // fall through
+    case ParticleType::AoS:
+    case ParticleType::synched:
+      copyParticlesToCompact();
+      break;
+    case ParticleType::compact:
+      break;
+  }
+  particleType = ParticleType::compact;
+}
+
 // synched AoS and SoA conceptually implies a write-lock
 //
 void Particles3Dcomm::convertParticlesToSynched()
@@ -1964,6 +2646,10 @@ void Particles3Dcomm::convertParticlesToSynched()
   {
     default:
       unsupported_value_error(particleType);
+    case ParticleType::compact:
+      copyParticlesFromCompact();
+      copyParticlesToSoA();
+      break;
     case ParticleType::SoA:
       copyParticlesToAoS();
       break;
@@ -1986,6 +2672,9 @@ void Particles3Dcomm::convertParticlesToAoS()
   {
     default:
       unsupported_value_error(particleType);
+    case ParticleType::compact:
+      copyParticlesFromCompact();
+      break;
     case ParticleType::SoA:
       copyParticlesToAoS();
       break;
@@ -2004,6 +2693,7 @@ bool Particles3Dcomm::particlesAreSoA()const
     default:
       unsupported_value_error(particleType);
     case ParticleType::AoS:
+    case ParticleType::compact:
       return false;
       break;
     case ParticleType::SoA:
@@ -2022,6 +2712,10 @@ void Particles3Dcomm::convertParticlesToSoA()
   {
     default:
       unsupported_value_error(particleType);
+    case ParticleType::compact:
+      copyParticlesFromCompact();
+      copyParticlesToSoA();
+      break;
     case ParticleType::AoS:
       copyParticlesToSoA();
       break;
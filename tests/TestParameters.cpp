@@ -0,0 +1,34 @@
+#include "TestParameters.h"
+
+// parameters that tests may change at run time
+//
+namespace TestParameters
+{
+  bool VECTORIZE_MOMENTS = false;
+  Parameters::Enum MOMENTS_TYPE = Parameters::AoS;
+  int MOMENT_TILE_SIZE = 8;
+  bool SIMD_MOMENTS = false;
+  bool FLOAT_MOMENT_TILES = false;
+  Parameters::Enum MOVER_TYPE = Parameters::AoS;
+  int MOVER_CHUNK_SIZE = 0;
+  bool COMPACT_PCLS = false;
+  bool CACHE_PCL_CELLS = false;
+  bool DIRECT_PCL_EXCHANGE = false;
+  int RESAMPLE_CYCLE = 0;
+  bool COUNTER_BASED_RNG = false;
+  bool ADAPTIVE_BLOCKS = false;
+}
+
+bool Parameters::get_VECTORIZE_MOMENTS() { return TestParameters::VECTORIZE_MOMENTS; }
+Parameters::Enum Parameters::get_MOMENTS_TYPE() { return TestParameters::MOMENTS_TYPE; }
+int Parameters::get_MOMENT_TILE_SIZE() { return TestParameters::MOMENT_TILE_SIZE; }
+bool Parameters::get_SIMD_MOMENTS() { return TestParameters::SIMD_MOMENTS; }
+bool Parameters::get_FLOAT_MOMENT_TILES() { return TestParameters::FLOAT_MOMENT_TILES; }
+Parameters::Enum Parameters::get_MOVER_TYPE() { return TestParameters::MOVER_TYPE; }
+int Parameters::get_MOVER_CHUNK_SIZE() { return TestParameters::MOVER_CHUNK_SIZE; }
+bool Parameters::get_COMPACT_PCLS() { return TestParameters::COMPACT_PCLS; }
+bool Parameters::get_CACHE_PCL_CELLS() { return TestParameters::CACHE_PCL_CELLS; }
+bool Parameters::get_DIRECT_PCL_EXCHANGE() { return TestParameters::DIRECT_PCL_EXCHANGE; }
+int Parameters::get_RESAMPLE_CYCLE() { return TestParameters::RESAMPLE_CYCLE; }
+bool Parameters::get_COUNTER_BASED_RNG() { return TestParameters::COUNTER_BASED_RNG; }
+bool Parameters::get_ADAPTIVE_BLOCKS() { return TestParameters::ADAPTIVE_BLOCKS; }
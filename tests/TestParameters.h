@@ -0,0 +1,32 @@
+#ifndef _TestParameters_h_
+#define _TestParameters_h_
+
+#include "Parameters.h"
+
+// values returned by the "edit these parameters" methods of
+// Parameters in the tests (see TestParameters.cpp)
+//
+// The defaults are those of main/EditParameters.cpp.  Parameters that
+// are read when an object is created must be set before it is
+// created, and Parameters::init_parameters() must be called again
+// after changing MOVER_TYPE, MOMENTS_TYPE, VECTORIZE_MOMENTS
+// or COMPACT_PCLS.
+//
+namespace TestParameters
+{
+  extern bool VECTORIZE_MOMENTS;
+  extern Parameters::Enum MOMENTS_TYPE;
+  extern int MOMENT_TILE_SIZE;
+  extern bool SIMD_MOMENTS;
+  extern bool FLOAT_MOMENT_TILES;
+  extern Parameters::Enum MOVER_TYPE;
+  extern int MOVER_CHUNK_SIZE;
+  extern bool COMPACT_PCLS;
+  extern bool CACHE_PCL_CELLS;
+  extern bool DIRECT_PCL_EXCHANGE;
+  extern int RESAMPLE_CYCLE;
+  extern bool COUNTER_BASED_RNG;
+  extern bool ADAPTIVE_BLOCKS;
+}
+
+#endif
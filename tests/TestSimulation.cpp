@@ -0,0 +1,71 @@
+#include <mpi.h>
+#include <stdlib.h>
+#include <new> // for placement new
+#include "TestSimulation.h"
+#include "MPIdata.h"
+#include "Collective.h"
+#include "VCtopology3D.h"
+#include "Grid3DCU.h"
+#include "EMfields3D.h"
+#include "Particles3D.h"
+#include "errors.h"
+
+TestSimulation::TestSimulation(const char* inputfile)
+{
+  Parameters::init_parameters();
+  // Collective reads the input file named by argv[1]
+  char* argv[2] = {(char*) "test", (char*) inputfile};
+  col = new Collective(2, argv);
+  ns = col->getNs();
+  vct = new VCtopology3D(*col);
+  if(MPIdata::get_nprocs() != vct->getNprocs())
+  {
+    eprintf("%s needs %d processes", inputfile, vct->getNprocs());
+  }
+  vct->setup_vctopology(MPI_COMM_WORLD);
+  grid = new Grid3DCU(col, vct);
+}
+
+TestSimulation::~TestSimulation()
+{
+  delete grid;
+  delete vct;
+  delete col;
+}
+
+EMfields3D* TestSimulation::new_fields()
+{
+  EMfields3D* EMf = new EMfields3D(col, grid);
+  if(col->getCase()=="GEM")
+    EMf->initGEM(vct, grid, col);
+  else
+    EMf->init(vct, grid, col);
+  EMf->updateInfoFields(grid, vct, col);
+  return EMf;
+}
+
+Particles3D* TestSimulation::new_particles()
+{
+  Particles3D* part = (Particles3D*) malloc(sizeof(Particles3D)*ns);
+  for (int i = 0; i < ns; i++)
+    new(&part[i]) Particles3D(i, col, vct, grid);
+  return part;
+}
+
+void TestSimulation::delete_particles(Particles3D* part)
+{
+  for (int i = 0; i < ns; i++)
+    part[i].~Particles3D();
+  free(part);
+}
+
+Particles3D* TestSimulation::new_maxwellian_particles(EMfields3D* EMf)
+{
+  Particles3D* part = new_particles();
+  for (int i = 0; i < ns; i++)
+  {
+    part[i].maxwellian(EMf);
+    part[i].reserve_remaining_particle_IDs();
+  }
+  return part;
+}
@@ -0,0 +1,33 @@
+#ifndef _TestSimulation_h_
+#define _TestSimulation_h_
+
+#include "ipicfwd.h"
+
+class Particles3D;
+
+// the objects of a small simulation, created from an input file
+// as in c_Solver::Init() (without output or restart)
+//
+// Fields and particles are created on request, so that a test
+// can create several sets of them with different parameters.
+//
+class TestSimulation
+{
+ public:
+  TestSimulation(const char* inputfile);
+  ~TestSimulation();
+  // fields initialized for the case of the input file
+  EMfields3D* new_fields();
+  // the (empty) particles of each species
+  Particles3D* new_particles();
+  void delete_particles(Particles3D* part);
+  // the particles of each species, initialized by maxwellian()
+  Particles3D* new_maxwellian_particles(EMfields3D* EMf);
+ public:
+  Collective* col;
+  VCtopology3D* vct;
+  Grid3DCU* grid;
+  int ns;
+};
+
+#endif
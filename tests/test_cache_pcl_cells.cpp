@@ -0,0 +1,120 @@
+// test that caching the cell of each particle in the mover
+// (see Parameters::get_CACHE_PCL_CELLS()) changes neither the
+// particles nor their moments: a few cycles of pushing,
+// exchanging, sorting, and summing moments give the same
+// result bit for bit with and without cached cells
+//
+// run on 4 processes with inputs/test_cache_pcl_cells.inp
+//
+#include <mpi.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "MPIdata.h"
+#include "Grid3DCU.h"
+#include "EMfields3D.h"
+#include "Particles3D.h"
+#include "errors.h"
+#include "TimeTasks.h"
+#include "TestParameters.h"
+#include "TestSimulation.h"
+
+// the state at the end of the cycles
+struct Result
+{
+  std::vector<std::vector<SpeciesParticle> > pcls;
+  std::vector<double> moments;
+};
+
+static void run_cycles(TestSimulation& sim, bool caching_cells, Result& result)
+{
+  TestParameters::CACHE_PCL_CELLS = caching_cells;
+  EMfields3D* EMf = sim.new_fields();
+  Particles3D* part = sim.new_maxwellian_particles(EMf);
+  const int ns = sim.ns;
+
+  // the fields are not advanced, so the particles
+  // are pushed by the initial fields
+  const int num_cycles = 3;
+  for(int cycle=0;cycle<num_cycles;cycle++)
+  {
+    // as in c_Solver::ParticlesMover()
+    {
+      timeTasks_set_main_task(TimeTasks::PARTICLES);
+      EMf->set_fieldForPcls();
+      for(int is=0;is<ns;is++)
+        part[is].pad_capacities();
+      #pragma omp parallel
+      {
+        for(int is=0;is<ns;is++)
+          part[is].mover_PC_AoS(EMf);
+        for(int is=0;is<ns;is++)
+          part[is].separate_and_send_particles();
+      }
+      Particles3Dcomm::recommunicate_species_until_done(part, ns, 1);
+    }
+    // as in c_Solver::CalculateMoments(), with sorting
+    {
+      timeTasks_set_main_task(TimeTasks::MOMENTS);
+      for(int is=0;is<ns;is++)
+      {
+        part[is].update_pcl_cells();
+        part[is].sort_particles_serial();
+      }
+      EMf->setZeroPrimaryMoments();
+      EMf->sumMoments_AoS(part, sim.grid, sim.vct);
+    }
+  }
+
+  result.pcls.resize(ns);
+  for(int is=0;is<ns;is++)
+  {
+    const vector_SpeciesParticle& list = part[is].get_pcl_list();
+    result.pcls[is].assign(&list[0], &list[0]+list.size());
+  }
+  const arr4_double arrays[4] = {
+    EMf->getRHOns(), EMf->getJxs(), EMf->getJys(), EMf->getJzs()};
+  const Grid3DCU& grid = *sim.grid;
+  result.moments.clear();
+  for(int m=0;m<4;m++)
+  for(int is=0;is<ns;is++)
+  for(int i=0;i<grid.getNXN();i++)
+  for(int j=0;j<grid.getNYN();j++)
+  for(int k=0;k<grid.getNZN();k++)
+    result.moments.push_back(arrays[m].get(is,i,j,k));
+
+  sim.delete_particles(part);
+  delete EMf;
+}
+
+int main(int argc, char **argv)
+{
+  MPIdata::init(&argc, &argv);
+  if(argc < 2)
+    eprintf("usage: test_cache_pcl_cells <input file>");
+  {
+    TestSimulation sim(argv[1]);
+    timeTasks.resetCycle();
+    if(!MPIdata::get_rank())
+      printf("=== testing cycles with and without cached cells ===\n");
+    Result uncached, cached;
+    run_cycles(sim, false, uncached);
+    run_cycles(sim, true, cached);
+    for(int is=0;is<sim.ns;is++)
+    {
+      const std::vector<SpeciesParticle>& pcls0 = uncached.pcls[is];
+      const std::vector<SpeciesParticle>& pcls1 = cached.pcls[is];
+      if(pcls0.size() != pcls1.size())
+        eprintf("species %d has %d particles without cached cells"
+          " but %d with them", is, int(pcls0.size()), int(pcls1.size()));
+      if(pcls0.size() && memcmp(&pcls0[0], &pcls1[0],
+          pcls0.size()*sizeof(SpeciesParticle)))
+        eprintf("the particles of species %d depend on cached cells", is);
+    }
+    if(memcmp(&uncached.moments[0], &cached.moments[0],
+        uncached.moments.size()*sizeof(double)))
+      eprintf("the moments depend on cached cells");
+  }
+  MPIdata::instance().finalize_mpi();
+  return 0;
+}
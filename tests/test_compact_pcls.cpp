@@ -0,0 +1,174 @@
+// test the compact particles (see Parameters::get_COMPACT_PCLS()):
+// converting particles to the compact format and back, and
+// pushing them with mover_PC_compact(), agree with the AoS
+// particles up to the precision of the compact format
+//
+// The compact format keeps the offset of the particle in its
+// cell, its velocity, and its charge in single precision, so
+// after a conversion or a push
+//
+// - each coordinate of the position is within FLT_EPSILON
+//   of the width of a cell, and
+// - the velocity and the charge are within FLT_EPSILON/2
+//   relative to their values (the rounding to single precision)
+//   plus the roundoff of the push in double precision.
+//
+// run on 2 processes with inputs/test_compact_pcls.inp
+//
+#include <mpi.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <vector>
+#include <algorithm>
+#include "MPIdata.h"
+#include "Grid3DCU.h"
+#include "EMfields3D.h"
+#include "Particles3D.h"
+#include "errors.h"
+#include "TimeTasks.h"
+#include "TestParameters.h"
+#include "TestSimulation.h"
+
+// the particles of a species in AoS format
+static void get_pcls(std::vector<SpeciesParticle>& pcls,
+  Particles3Dcomm& species)
+{
+  species.convertParticlesToAoS();
+  const vector_SpeciesParticle& list = species.get_pcl_list();
+  pcls.assign(&list[0], &list[0]+list.size());
+}
+
+// the compact particles of a species, expanded
+static void get_compact_pcls(std::vector<SpeciesParticle>& pcls,
+  const Particles3Dcomm& species)
+{
+  pcls.resize(species.getNOP());
+  for(int pidx=0;pidx<pcls.size();pidx++)
+    species.unpack_pcl(pcls[pidx], species.get_cpcl(pidx));
+}
+
+// push the particles once, as in c_Solver::ParticlesMover(),
+// and get them before the emigrants are removed
+static void push(std::vector<std::vector<SpeciesParticle> >& pcls,
+  TestSimulation& sim, EMfields3D* EMf, Particles3D* part, bool compact)
+{
+  const int ns = sim.ns;
+  timeTasks_set_main_task(TimeTasks::PARTICLES);
+  EMf->set_fieldForPcls();
+  #pragma omp parallel
+  {
+    for(int is=0;is<ns;is++)
+    {
+      if(compact)
+        part[is].mover_PC_compact(EMf);
+      else
+        part[is].mover_PC_AoS(EMf);
+    }
+  }
+  pcls.resize(ns);
+  for(int is=0;is<ns;is++)
+  {
+    if(compact)
+      get_compact_pcls(pcls[is], part[is]);
+    else
+      get_pcls(pcls[is], part[is]);
+  }
+  #pragma omp parallel
+  {
+    for(int is=0;is<ns;is++)
+      part[is].separate_and_send_particles();
+  }
+  Particles3Dcomm::recommunicate_species_until_done(part, ns, 1);
+}
+
+// check that the particles agree within the stated tolerances;
+// the velocities also differ by the roundoff of a push relative
+// to the largest velocity
+static void check_pcls(const Grid3DCU& grid,
+  const std::vector<SpeciesParticle>& pcls,
+  const std::vector<SpeciesParticle>& expected,
+  int is, const char* what, double push_roundoff = 0.)
+{
+  if(pcls.size() != expected.size())
+    eprintf("%s: species %d has %d particles instead of %d",
+      what, is, int(pcls.size()), int(expected.size()));
+  double umax = 0.;
+  for(int pidx=0;pidx<expected.size();pidx++)
+  for(int i=0;i<3;i++)
+    umax = std::max(umax, fabs(expected[pidx].get_u(i)));
+  const double cell_width[3] = {grid.getDX(), grid.getDY(), grid.getDZ()};
+  for(int pidx=0;pidx<expected.size();pidx++)
+  {
+    const SpeciesParticle& pcl = pcls[pidx];
+    const SpeciesParticle& pcl0 = expected[pidx];
+    for(int i=0;i<3;i++)
+    {
+      const double xtol = FLT_EPSILON*cell_width[i];
+      if(fabs(pcl.get_x(i)-pcl0.get_x(i)) > xtol)
+        eprintf("%s: position %d of particle %d of species %d"
+          " is %.17g instead of %.17g",
+          what, i, pidx, is, pcl.get_x(i), pcl0.get_x(i));
+      const double utol = FLT_EPSILON/2*fabs(pcl0.get_u(i))
+        + push_roundoff*umax;
+      if(fabs(pcl.get_u(i)-pcl0.get_u(i)) > utol)
+        eprintf("%s: velocity %d of particle %d of species %d"
+          " is %.17g instead of %.17g",
+          what, i, pidx, is, pcl.get_u(i), pcl0.get_u(i));
+    }
+    if(fabs(pcl.get_q()-pcl0.get_q()) > FLT_EPSILON/2*fabs(pcl0.get_q()))
+      eprintf("%s: charge of particle %d of species %d"
+        " is %.17g instead of %.17g",
+        what, pidx, is, pcl.get_q(), pcl0.get_q());
+  }
+}
+
+int main(int argc, char **argv)
+{
+  MPIdata::init(&argc, &argv);
+  if(argc < 2)
+    eprintf("usage: test_compact_pcls <input file>");
+  {
+    TestParameters::COMPACT_PCLS = true;
+    TestSimulation sim(argv[1]);
+    Parameters::init_parameters();
+    timeTasks.resetCycle();
+    const int ns = sim.ns;
+    EMfields3D* EMf = sim.new_fields();
+
+    if(!MPIdata::get_rank())
+      printf("=== testing conversion to compact particles and back ===\n");
+    Particles3D* part = sim.new_maxwellian_particles(EMf);
+    std::vector<SpeciesParticle> pcls, expected;
+    for(int is=0;is<ns;is++)
+    {
+      get_pcls(expected, part[is]);
+      part[is].convertParticlesToCompact();
+      get_pcls(pcls, part[is]);
+      check_pcls(*sim.grid, pcls, expected, is, "conversion");
+    }
+
+    if(!MPIdata::get_rank())
+      printf("=== testing a push of compact particles ===\n");
+    // both sets of particles start from the converted particles
+    // (which the compact format represents), so they differ
+    // only in the push and in storing its result
+    Particles3D* aos_part = sim.new_maxwellian_particles(EMf);
+    for(int is=0;is<ns;is++)
+    {
+      aos_part[is].convertParticlesToCompact();
+      aos_part[is].convertParticlesToAoS();
+    }
+    std::vector<std::vector<SpeciesParticle> > pushed, aos_pushed;
+    push(pushed, sim, EMf, part, true);
+    push(aos_pushed, sim, EMf, aos_part, false);
+    // (the pushes themselves agree up to roundoff)
+    for(int is=0;is<ns;is++)
+      check_pcls(*sim.grid, pushed[is], aos_pushed[is], is, "push", 1e-14);
+    sim.delete_particles(aos_part);
+    sim.delete_particles(part);
+    delete EMf;
+  }
+  MPIdata::instance().finalize_mpi();
+  return 0;
+}
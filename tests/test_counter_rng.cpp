@@ -0,0 +1,69 @@
+// test that particles initialized with the counter-based random
+// number generator (see Parameters::get_COUNTER_BASED_RNG())
+// are the same bit for bit for any number of threads
+//
+// (meaningful only if compiled with OpenMP)
+//
+// run on 2 processes with inputs/test_counter_rng.inp
+//
+#include <mpi.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "MPIdata.h"
+#include "ompdefs.h"
+#include "EMfields3D.h"
+#include "Particles3D.h"
+#include "errors.h"
+#include "TimeTasks.h"
+#include "TestParameters.h"
+#include "TestSimulation.h"
+
+typedef std::vector<SpeciesParticle> Pcls;
+
+// the particles of each species initialized with num_threads threads
+static void init_pcls(TestSimulation& sim, EMfields3D* EMf,
+  int num_threads, std::vector<Pcls>& pcls)
+{
+  set_max_threads_for_scope(num_threads);
+  Particles3D* part = sim.new_maxwellian_particles(EMf);
+  pcls.resize(sim.ns);
+  for(int is=0;is<sim.ns;is++)
+  {
+    const vector_SpeciesParticle& list = part[is].get_pcl_list();
+    pcls[is].assign(&list[0], &list[0]+list.size());
+  }
+  sim.delete_particles(part);
+}
+
+int main(int argc, char **argv)
+{
+  MPIdata::init(&argc, &argv);
+  if(argc < 2)
+    eprintf("usage: test_counter_rng <input file>");
+  {
+    TestSimulation sim(argv[1]);
+    timeTasks.resetCycle();
+    TestParameters::COUNTER_BASED_RNG = true;
+    EMfields3D* EMf = sim.new_fields();
+    if(!MPIdata::get_rank())
+      printf("=== testing particles initialized with 1 and 4 threads ===\n");
+    std::vector<Pcls> pcls1, pcls4;
+    init_pcls(sim, EMf, 1, pcls1);
+    init_pcls(sim, EMf, 4, pcls4);
+    for(int is=0;is<sim.ns;is++)
+    {
+      if(pcls1[is].size() != pcls4[is].size())
+        eprintf("species %d has %d particles with 1 thread but %d with 4",
+          is, int(pcls1[is].size()), int(pcls4[is].size()));
+      if(pcls1[is].empty())
+        eprintf("species %d has no particles", is);
+      if(memcmp(&pcls1[is][0], &pcls4[is][0],
+          pcls1[is].size()*sizeof(SpeciesParticle)))
+        eprintf("the particles of species %d depend on the number of threads", is);
+    }
+    delete EMf;
+  }
+  MPIdata::instance().finalize_mpi();
+  return 0;
+}
@@ -0,0 +1,161 @@
+// test that the moments summed tile by tile
+// (EMfields3D::sumMoments_tiled()) or one color of tiles at a
+// time (EMfields3D::sumMoments_colored()), with or without vector
+// lanes (see Parameters::get_SIMD_MOMENTS()), agree to roundoff
+// with those of the scalar sum (EMfields3D::sumMoments_AoS())
+//
+// run on 2 processes with inputs/test_moments.inp
+//
+#include <mpi.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <vector>
+#include "MPIdata.h"
+#include "Grid3DCU.h"
+#include "EMfields3D.h"
+#include "Particles3D.h"
+#include "errors.h"
+#include "TimeTasks.h"
+#include "TestParameters.h"
+#include "TestSimulation.h"
+
+const int num_moments = 10;
+const char* moment_names[num_moments] =
+  {"rho", "Jx", "Jy", "Jz", "pXX", "pXY", "pXZ", "pYY", "pYZ", "pZZ"};
+
+// the moments of each species on the nodes,
+// summed with the current moments parameters
+//
+static void sum_moments(TestSimulation& sim, Particles3D* part,
+  std::vector<double>& moments)
+{
+  timeTasks_set_main_task(TimeTasks::MOMENTS);
+  Parameters::init_parameters();
+  EMfields3D* EMf = sim.new_fields();
+  // sum the pressures of every species
+  EMf->set_pressure_output(true);
+  EMf->setZeroPrimaryMoments();
+  if(Parameters::get_SORTING_PARTICLES())
+  {
+    for(int is=0;is<sim.ns;is++)
+      part[is].sort_particles_serial();
+  }
+  switch(Parameters::get_MOMENTS_TYPE())
+  {
+    case Parameters::AoS:
+      EMf->sumMoments_AoS(part, sim.grid, sim.vct);
+      break;
+    case Parameters::AoStiled:
+      EMf->sumMoments_tiled(part, sim.grid, sim.vct);
+      break;
+    case Parameters::AoScolored:
+      EMf->sumMoments_colored(part, sim.grid, sim.vct);
+      break;
+    default:
+      unsupported_value_error(Parameters::get_MOMENTS_TYPE());
+  }
+  const arr4_double arrays[num_moments] = {
+    EMf->getRHOns(), EMf->getJxs(), EMf->getJys(), EMf->getJzs(),
+    EMf->getpXXsn(), EMf->getpXYsn(), EMf->getpXZsn(),
+    EMf->getpYYsn(), EMf->getpYZsn(), EMf->getpZZsn()};
+  const Grid3DCU& grid = *sim.grid;
+  moments.clear();
+  for(int m=0;m<num_moments;m++)
+  for(int is=0;is<sim.ns;is++)
+  for(int i=0;i<grid.getNXN();i++)
+  for(int j=0;j<grid.getNYN();j++)
+  for(int k=0;k<grid.getNZN();k++)
+    moments.push_back(arrays[m].get(is,i,j,k));
+  delete EMf;
+}
+
+// compare each moment of each species with the scalar sum,
+// relative to the largest value of the moment (by default up
+// to the roundoff of summing in a different order)
+//
+static void check_moments(TestSimulation& sim,
+  const std::vector<double>& moments,
+  const std::vector<double>& expected, const char* method,
+  double tol = 1e-12)
+{
+  const Grid3DCU& grid = *sim.grid;
+  const int num_nodes = grid.getNXN()*grid.getNYN()*grid.getNZN();
+  for(int m=0;m<num_moments;m++)
+  for(int is=0;is<sim.ns;is++)
+  {
+    const int first = (m*sim.ns + is)*num_nodes;
+    double max_abs = 0.;
+    for(int n=first;n<first+num_nodes;n++)
+      max_abs = fabs(expected[n]) > max_abs ? fabs(expected[n]) : max_abs;
+    for(int n=first;n<first+num_nodes;n++)
+    {
+      if(fabs(moments[n]-expected[n]) > tol*max_abs)
+        eprintf("%s: %s of species %d is %.17g rather than %.17g",
+          method, moment_names[m], is, moments[n], expected[n]);
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  MPIdata::init(&argc, &argv);
+  if(argc < 2)
+    eprintf("usage: test_moments <input file>");
+  {
+    TestSimulation sim(argv[1]);
+    timeTasks.resetCycle();
+    EMfields3D* EMf = sim.new_fields();
+    Particles3D* part = sim.new_maxwellian_particles(EMf);
+    delete EMf;
+
+    std::vector<double> expected, moments;
+    TestParameters::MOMENTS_TYPE = Parameters::AoS;
+    sum_moments(sim, part, expected);
+
+    // tiles that do and do not divide the cells of a process
+    const int tile_sizes[2] = {3, 8};
+    for(int t=0;t<2;t++)
+    {
+      TestParameters::MOMENT_TILE_SIZE = tile_sizes[t];
+      if(!MPIdata::get_rank())
+        printf("=== testing tiled moments (tile size %d) ===\n", tile_sizes[t]);
+      TestParameters::MOMENTS_TYPE = Parameters::AoStiled;
+      sum_moments(sim, part, moments);
+      check_moments(sim, moments, expected, "tiled");
+
+      if(!MPIdata::get_rank())
+        printf("=== testing colored moments (tile size %d) ===\n", tile_sizes[t]);
+      TestParameters::MOMENTS_TYPE = Parameters::AoScolored;
+      sum_moments(sim, part, moments);
+      check_moments(sim, moments, expected, "colored");
+    }
+    TestParameters::MOMENT_TILE_SIZE = 3;
+    TestParameters::SIMD_MOMENTS = true;
+    if(!MPIdata::get_rank())
+      printf("=== testing tiled moments summed in vector lanes ===\n");
+    TestParameters::MOMENTS_TYPE = Parameters::AoStiled;
+    sum_moments(sim, part, moments);
+    check_moments(sim, moments, expected, "tiled SIMD");
+    if(!MPIdata::get_rank())
+      printf("=== testing colored moments summed in vector lanes ===\n");
+    TestParameters::MOMENTS_TYPE = Parameters::AoScolored;
+    sum_moments(sim, part, moments);
+    check_moments(sim, moments, expected, "colored SIMD");
+    TestParameters::SIMD_MOMENTS = false;
+
+    TestParameters::FLOAT_MOMENT_TILES = true;
+    if(!MPIdata::get_rank())
+      printf("=== testing tiled moments stored in single precision ===\n");
+    TestParameters::MOMENTS_TYPE = Parameters::AoStiled;
+    sum_moments(sim, part, moments);
+    // each cell's moments are summed in double and added to the
+    // float tile once, so a node of a tile takes at most 8 roundings
+    // to single precision, however many particles are in its cells
+    check_moments(sim, moments, expected, "tiled float", 8*FLT_EPSILON);
+    TestParameters::FLOAT_MOMENT_TILES = false;
+    sim.delete_particles(part);
+  }
+  MPIdata::instance().finalize_mpi();
+  return 0;
+}
@@ -0,0 +1,154 @@
+// test that pushing the particles of all species in chunks
+// (see Parameters::get_MOVER_CHUNK_SIZE()) changes neither the
+// particles nor their moments: a few cycles of pushing,
+// exchanging, sorting, and summing moments give the same
+// result bit for bit as pushing each species in turn
+//
+// run on 4 processes with inputs/test_mover_chunks.inp
+//
+#include <mpi.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "MPIdata.h"
+#include "Grid3DCU.h"
+#include "EMfields3D.h"
+#include "Particles3D.h"
+#include "errors.h"
+#include "TimeTasks.h"
+#include "TestParameters.h"
+#include "TestSimulation.h"
+
+// the state at the end of the cycles
+struct Result
+{
+  std::vector<std::vector<SpeciesParticle> > pcls;
+  std::vector<double> moments;
+};
+
+static void run_cycles(TestSimulation& sim, int chunk_size,
+  bool caching_cells, Result& result)
+{
+  TestParameters::MOVER_CHUNK_SIZE = chunk_size;
+  TestParameters::CACHE_PCL_CELLS = caching_cells;
+  EMfields3D* EMf = sim.new_fields();
+  Particles3D* part = sim.new_maxwellian_particles(EMf);
+  const int ns = sim.ns;
+
+  // the fields are not advanced, so the particles
+  // are pushed by the initial fields
+  const int num_cycles = 3;
+  for(int cycle=0;cycle<num_cycles;cycle++)
+  {
+    // as in c_Solver::ParticlesMover()
+    {
+      timeTasks_set_main_task(TimeTasks::PARTICLES);
+      EMf->set_fieldForPcls();
+      for(int is=0;is<ns;is++)
+        part[is].pad_capacities();
+      #pragma omp parallel
+      {
+        if(chunk_size > 0)
+          Particles3D::mover_PC_AoS_in_chunks(part, ns, EMf);
+        else for(int is=0;is<ns;is++)
+          part[is].mover_PC_AoS(EMf);
+        for(int is=0;is<ns;is++)
+          part[is].separate_and_send_particles();
+      }
+      Particles3Dcomm::recommunicate_species_until_done(part, ns, 1);
+    }
+    // as in c_Solver::CalculateMoments(), with sorting
+    {
+      timeTasks_set_main_task(TimeTasks::MOMENTS);
+      for(int is=0;is<ns;is++)
+      {
+        part[is].update_pcl_cells();
+        part[is].sort_particles_serial();
+      }
+      EMf->setZeroPrimaryMoments();
+      EMf->sumMoments_AoS(part, sim.grid, sim.vct);
+    }
+  }
+
+  result.pcls.resize(ns);
+  for(int is=0;is<ns;is++)
+  {
+    const vector_SpeciesParticle& list = part[is].get_pcl_list();
+    result.pcls[is].assign(&list[0], &list[0]+list.size());
+  }
+  const arr4_double arrays[4] = {
+    EMf->getRHOns(), EMf->getJxs(), EMf->getJys(), EMf->getJzs()};
+  const Grid3DCU& grid = *sim.grid;
+  result.moments.clear();
+  for(int m=0;m<4;m++)
+  for(int is=0;is<ns;is++)
+  for(int i=0;i<grid.getNXN();i++)
+  for(int j=0;j<grid.getNYN();j++)
+  for(int k=0;k<grid.getNZN();k++)
+    result.moments.push_back(arrays[m].get(is,i,j,k));
+
+  sim.delete_particles(part);
+  delete EMf;
+  TestParameters::MOVER_CHUNK_SIZE = 0;
+  TestParameters::CACHE_PCL_CELLS = false;
+}
+
+static void check_result(TestSimulation& sim, const Result& result,
+  const Result& expected, const char* method)
+{
+  for(int is=0;is<sim.ns;is++)
+  {
+    const std::vector<SpeciesParticle>& pcls = result.pcls[is];
+    const std::vector<SpeciesParticle>& pcls0 = expected.pcls[is];
+    if(pcls.size() != pcls0.size())
+      eprintf("species %d has %d particles pushed %s"
+        " but %d pushed by species", is, int(pcls.size()),
+        method, int(pcls0.size()));
+    if(pcls.size() && memcmp(&pcls[0], &pcls0[0],
+        pcls.size()*sizeof(SpeciesParticle)))
+      eprintf("the particles of species %d differ when pushed %s",
+        is, method);
+  }
+  if(memcmp(&result.moments[0], &expected.moments[0],
+      result.moments.size()*sizeof(double)))
+    eprintf("the moments differ when the particles are pushed %s", method);
+}
+
+int main(int argc, char **argv)
+{
+  MPIdata::init(&argc, &argv);
+  if(argc < 2)
+    eprintf("usage: test_mover_chunks <input file>");
+  {
+    TestSimulation sim(argv[1]);
+    timeTasks.resetCycle();
+    if(!MPIdata::get_rank())
+      printf("=== testing cycles with each species pushed in turn ===\n");
+    Result by_species;
+    run_cycles(sim, 0, false, by_species);
+
+    // chunks much smaller than the particles of a species,
+    // and chunks that do not divide them evenly
+    const int chunk_sizes[2] = {64, 1000};
+    for(int c=0;c<2;c++)
+    {
+      if(!MPIdata::get_rank())
+        printf("=== testing cycles with chunks of %d particles ===\n",
+          chunk_sizes[c]);
+      Result in_chunks;
+      run_cycles(sim, chunk_sizes[c], false, in_chunks);
+      check_result(sim, in_chunks, by_species, "in chunks");
+    }
+
+    // the chunked mover caches cells in its own way
+    if(!MPIdata::get_rank())
+      printf("=== testing cycles with chunks and cached cells ===\n");
+    Result cached_by_species, cached_in_chunks;
+    run_cycles(sim, 0, true, cached_by_species);
+    run_cycles(sim, 1000, true, cached_in_chunks);
+    check_result(sim, cached_in_chunks, cached_by_species,
+      "in chunks with cached cells");
+  }
+  MPIdata::instance().finalize_mpi();
+  return 0;
+}
@@ -0,0 +1,138 @@
+// test that the pressures of species that neglect them
+// (NeglectPressure in the input file) are summed only for output
+// and do not change the electric field: the field computed from
+// the moments is the same bit for bit whether or not the cycle
+// outputs pressures (see EMfields3D::set_pressure_output())
+//
+// run on 2 processes with inputs/test_neglect_pressure.inp
+//
+#include <mpi.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "MPIdata.h"
+#include "Collective.h"
+#include "Grid3DCU.h"
+#include "EMfields3D.h"
+#include "Particles3D.h"
+#include "errors.h"
+#include "TimeTasks.h"
+#include "TestParameters.h"
+#include "TestSimulation.h"
+
+// the state after the field solve
+struct Result
+{
+  std::vector<double> E;
+  // the pressures of each species on the nodes
+  std::vector<std::vector<double> > pressures;
+};
+
+static void append(std::vector<double>& values, const arr3_double& array,
+  const Grid3DCU& grid)
+{
+  for(int i=0;i<grid.getNXN();i++)
+  for(int j=0;j<grid.getNYN();j++)
+  for(int k=0;k<grid.getNZN();k++)
+    values.push_back(array.get(i,j,k));
+}
+
+static void append(std::vector<double>& values, const arr4_double& array,
+  int is, const Grid3DCU& grid)
+{
+  for(int i=0;i<grid.getNXN();i++)
+  for(int j=0;j<grid.getNYN();j++)
+  for(int k=0;k<grid.getNZN();k++)
+    values.push_back(array.get(is,i,j,k));
+}
+
+// compute the moments (as in c_Solver::CalculateMoments())
+// and then the electric field
+//
+static void solve_field(TestSimulation& sim, bool pressure_output,
+  Result& result)
+{
+  Grid3DCU* grid = sim.grid;
+  VCtopology3D* vct = sim.vct;
+  EMfields3D* EMf = sim.new_fields();
+  Particles3D* part = sim.new_maxwellian_particles(EMf);
+  {
+    timeTasks_set_main_task(TimeTasks::MOMENTS);
+    EMf->set_pressure_output(pressure_output);
+    EMf->setZeroPrimaryMoments();
+    EMf->sumMoments_AoS(part, grid, vct);
+    EMf->setZeroDerivedMoments();
+    EMf->communicateGhostP2G_overlapped(grid, vct);
+    EMf->ConstantChargeOpenBC(grid, vct);
+    EMf->calculateHatFunctions(grid, vct);
+  }
+  {
+    timeTasks_set_main_task(TimeTasks::FIELDS);
+    EMf->calculateE(grid, vct, sim.col);
+  }
+
+  result.E.clear();
+  append(result.E, EMf->getEx(), *grid);
+  append(result.E, EMf->getEy(), *grid);
+  append(result.E, EMf->getEz(), *grid);
+  const arr4_double pressures[6] = {
+    EMf->getpXXsn(), EMf->getpXYsn(), EMf->getpXZsn(),
+    EMf->getpYYsn(), EMf->getpYZsn(), EMf->getpZZsn()};
+  result.pressures.resize(sim.ns);
+  for(int is=0;is<sim.ns;is++)
+  {
+    result.pressures[is].clear();
+    for(int p=0;p<6;p++)
+      append(result.pressures[is], pressures[p], is, *grid);
+  }
+
+  sim.delete_particles(part);
+  delete EMf;
+}
+
+static bool all_zero(const std::vector<double>& values)
+{
+  for(int i=0;i<values.size();i++)
+    if(values[i] != 0.) return false;
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  MPIdata::init(&argc, &argv);
+  if(argc < 2)
+    eprintf("usage: test_neglect_pressure <input file>");
+  {
+    TestSimulation sim(argv[1]);
+    timeTasks.resetCycle();
+    if(!MPIdata::get_rank())
+      printf("=== testing fields of cycles with and without pressure output ===\n");
+    Result with_output, without_output;
+    solve_field(sim, true, with_output);
+    solve_field(sim, false, without_output);
+
+    if(memcmp(&with_output.E[0], &without_output.E[0],
+        with_output.E.size()*sizeof(double)))
+      eprintf("the electric field depends on pressure output");
+    int num_neglected = 0;
+    for(int is=0;is<sim.ns;is++)
+    {
+      const std::vector<double>& p_output = with_output.pressures[is];
+      const std::vector<double>& p = without_output.pressures[is];
+      if(all_zero(p_output))
+        eprintf("no pressures were output for species %d", is);
+      if(sim.col->getNeglectPressure(is))
+      {
+        num_neglected++;
+        if(!all_zero(p))
+          eprintf("species %d neglects pressure, but it was summed", is);
+      }
+      else if(memcmp(&p_output[0], &p[0], p.size()*sizeof(double)))
+        eprintf("the pressures of species %d depend on pressure output", is);
+    }
+    if(!num_neglected)
+      eprintf("no species neglects pressure");
+  }
+  MPIdata::instance().finalize_mpi();
+  return 0;
+}
@@ -0,0 +1,120 @@
+// test that particles sent to each of the 26 neighbors of every
+// process arrive, with periodic shifts, in the right process,
+// whether exchanged one dimension at a time or directly
+// (see Parameters::get_DIRECT_PCL_EXCHANGE()), and whether or
+// not messages carry a signal element
+// (see Parameters::get_ADAPTIVE_BLOCKS())
+//
+// run on 8 processes with the input file pcl_exchange.inp
+//
+#include <mpi.h>
+#include <stdio.h>
+#include <math.h>
+#include "MPIdata.h"
+#include "Collective.h"
+#include "Grid3DCU.h"
+#include "Particles3D.h"
+#include "errors.h"
+#include "TimeTasks.h"
+#include "TestParameters.h"
+#include "TestSimulation.h"
+
+// position in [0,L) equivalent to x in a periodic domain
+static double wrap(double x, double L)
+{
+  if(x < 0.) return x + L;
+  if(x >= L) return x - L;
+  return x;
+}
+
+static void test_pcl_exchange(TestSimulation& sim, bool direct)
+{
+  timeTasks_set_main_task(TimeTasks::PARTICLES);
+  TestParameters::DIRECT_PCL_EXCHANGE = direct;
+  Particles3D* part = sim.new_particles();
+  Particles3D& pcls = part[0];
+  const Grid3DCU& grid = *sim.grid;
+  const double start[3] = {grid.getXstart(), grid.getYstart(), grid.getZstart()};
+  const double end[3] = {grid.getXend(), grid.getYend(), grid.getZend()};
+  const double L[3] = {sim.col->getLx(), sim.col->getLy(), sim.col->getLz()};
+
+  // from the center of this subdomain, place a particle in the
+  // middle of each neighboring subdomain and one at the center;
+  // its velocity is the position where it should arrive
+  // and its ID identifies it
+  const int rank = MPIdata::get_rank();
+  const int num_pcls_per_proc = 27;
+  int k = 0;
+  for(int dz=-1;dz<=1;dz++)
+  for(int dy=-1;dy<=1;dy++)
+  for(int dx=-1;dx<=1;dx++, k++)
+  {
+    const int d[3] = {dx, dy, dz};
+    double x[3], x_arrival[3];
+    for(int i=0;i<3;i++)
+    {
+      const double width = end[i]-start[i];
+      x[i] = start[i] + (0.5 + 0.75*d[i])*width;
+      x_arrival[i] = wrap(x[i], L[i]);
+    }
+    pcls.add_new_particle(x_arrival[0], x_arrival[1], x_arrival[2], 1.,
+      x[0], x[1], x[2], double(rank*num_pcls_per_proc + k));
+  }
+
+  pcls.separate_and_send_particles();
+  Particles3Dcomm::recommunicate_species_until_done(part, sim.ns, 1);
+
+  // every particle arrives where it should
+  const double tol = 1e-12;
+  double id_sum = 0.;
+  for(int pidx=0;pidx<pcls.getNOP();pidx++)
+  {
+    const SpeciesParticle& pcl = pcls.get_pcl(pidx);
+    if(pcls.test_outside_subdomain(pcl))
+      eprintf("particle %g is outside the subdomain", pcl.get_t());
+    for(int i=0;i<3;i++)
+    {
+      if(fabs(pcl.get_x(i) - pcl.get_u(i)) > tol)
+        eprintf("particle %g arrived at %g rather than %g in dimension %d",
+          pcl.get_t(), pcl.get_x(i), pcl.get_u(i), i);
+    }
+    id_sum += pcl.get_t();
+  }
+  // with two processes in each periodic dimension,
+  // each process receives as many as it sent
+  if(pcls.getNOP() != num_pcls_per_proc)
+    eprintf("%d particles arrived rather than %d",
+      pcls.getNOP(), num_pcls_per_proc);
+  // and each particle arrives once
+  double id_total;
+  MPI_Allreduce(&id_sum, &id_total, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  const double num_pcls = double(num_pcls_per_proc)*MPIdata::get_nprocs();
+  if(id_total != 0.5*num_pcls*(num_pcls-1))
+    eprintf("the particles arrived more than once");
+
+  sim.delete_particles(part);
+}
+
+int main(int argc, char **argv)
+{
+  MPIdata::init(&argc, &argv);
+  if(argc < 2)
+    eprintf("usage: test_pcl_exchange <input file>");
+  {
+    TestSimulation sim(argv[1]);
+    timeTasks.resetCycle();
+    if(!MPIdata::get_rank())
+      printf("=== testing exchange one dimension at a time ===\n");
+    test_pcl_exchange(sim, false);
+    if(!MPIdata::get_rank())
+      printf("=== testing direct exchange ===\n");
+    test_pcl_exchange(sim, true);
+    TestParameters::ADAPTIVE_BLOCKS = true;
+    if(!MPIdata::get_rank())
+      printf("=== testing direct exchange with adaptive blocks ===\n");
+    test_pcl_exchange(sim, true);
+    TestParameters::ADAPTIVE_BLOCKS = false;
+  }
+  MPIdata::instance().finalize_mpi();
+  return 0;
+}
@@ -0,0 +1,184 @@
+// test the repopulation of boundary layers
+// (see Particles3D::repopulate_particles()):
+//
+// - the particles of the cells outside the layers are kept,
+// - each proper cell of a layer holds npcel new particles
+//   in the cell, and the ghost cells beyond it hold none,
+// - the buckets index the new list, and
+// - the result is the same bit for bit for any number of threads
+//   (meaningful only if compiled with OpenMP).
+//
+// run on 2 processes with inputs/test_repopulate.inp
+//
+#include <mpi.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "MPIdata.h"
+#include "ompdefs.h"
+#include "Collective.h"
+#include "VCtopology3D.h"
+#include "Grid3DCU.h"
+#include "BcParticles.h"
+#include "EMfields3D.h"
+#include "Particles3D.h"
+#include "errors.h"
+#include "TimeTasks.h"
+#include "TestParameters.h"
+#include "TestSimulation.h"
+
+typedef std::vector<SpeciesParticle> Pcls;
+
+// whether a cell lies in a layer that this process repopulates
+// (num_layers cells wide, as in repopulate_particles())
+//
+static bool in_layer(TestSimulation& sim, int cx, int cy, int cz)
+{
+  using namespace BCparticles;
+  const int num_layers = 3;
+  const Collective& col = *sim.col;
+  const VCtopology3D& vct = *sim.vct;
+  const Grid3DCU& grid = *sim.grid;
+  return (vct.noXlowerNeighbor() && col.getBcPfaceXleft()==REEMISSION
+      && cx <= num_layers)
+    || (vct.noYlowerNeighbor() && col.getBcPfaceYleft()==REEMISSION
+      && cy <= num_layers)
+    || (vct.noZlowerNeighbor() && col.getBcPfaceZleft()==REEMISSION
+      && cz <= num_layers)
+    || (vct.noXupperNeighbor() && col.getBcPfaceXright()==REEMISSION
+      && cx >= grid.getNXC()-1-num_layers)
+    || (vct.noYupperNeighbor() && col.getBcPfaceYright()==REEMISSION
+      && cy >= grid.getNYC()-1-num_layers)
+    || (vct.noZupperNeighbor() && col.getBcPfaceZright()==REEMISSION
+      && cz >= grid.getNZC()-1-num_layers);
+}
+
+// check the particles of each species repopulated with
+// num_threads threads and return them
+//
+static void repopulate(TestSimulation& sim, EMfields3D* EMf,
+  int num_threads, std::vector<Pcls>& pcls)
+{
+  Particles3D* part = sim.new_maxwellian_particles(EMf);
+  // move the particles so that the cells no longer hold
+  // npcel particles each, as in c_Solver::ParticlesMover()
+  // (the fields are not advanced)
+  const int num_cycles = 3;
+  for(int cycle=0;cycle<num_cycles;cycle++)
+  {
+    EMf->set_fieldForPcls();
+    #pragma omp parallel
+    {
+      for(int is=0;is<sim.ns;is++)
+        part[is].mover_PC_AoS(EMf);
+      for(int is=0;is<sim.ns;is++)
+        part[is].separate_and_send_particles();
+    }
+    Particles3Dcomm::recommunicate_species_until_done(part, sim.ns, 1);
+  }
+  const Grid3DCU& grid = *sim.grid;
+  const int nxc = grid.getNXC();
+  const int nyc = grid.getNYC();
+  const int nzc = grid.getNZC();
+  pcls.resize(sim.ns);
+  for(int is=0;is<sim.ns;is++)
+  {
+    Particles3D& species = part[is];
+    // the particles of each cell before repopulation
+    species.sort_particles_serial();
+    const vector_SpeciesParticle& list = species.get_pcl_list();
+    const Pcls sorted(&list[0], &list[0]+list.size());
+    std::vector<int> offset0, count0;
+    for(int cx=0;cx<nxc;cx++)
+    for(int cy=0;cy<nyc;cy++)
+    for(int cz=0;cz<nzc;cz++)
+    {
+      offset0.push_back(species.get_bucket_offset(cx,cy,cz));
+      count0.push_back(species.get_numpcls_in_bucket(cx,cy,cz));
+    }
+
+    {
+      set_max_threads_for_scope(num_threads);
+      species.repopulate_particles();
+    }
+
+    const vector_SpeciesParticle& new_list = species.get_pcl_list();
+    const int npcel = sim.col->getNpcel(is);
+    int num_layer_cells = 0;
+    int offset = 0;
+    for(int cx=0;cx<nxc;cx++)
+    for(int cy=0;cy<nyc;cy++)
+    for(int cz=0;cz<nzc;cz++)
+    {
+      const int c = (cx*nyc+cy)*nzc+cz;
+      const int np = species.get_numpcls_in_bucket(cx,cy,cz);
+      if(species.get_bucket_offset(cx,cy,cz) != offset)
+        eprintf("bucket of cell (%d,%d,%d) of species %d is at %d"
+          " instead of %d", cx, cy, cz, is,
+          species.get_bucket_offset(cx,cy,cz), offset);
+      if(!in_layer(sim,cx,cy,cz))
+      {
+        if(np != count0[c] || (np && memcmp(&new_list[offset],
+            &sorted[offset0[c]], np*sizeof(SpeciesParticle))))
+          eprintf("the particles of species %d in cell (%d,%d,%d)"
+            " outside the layers changed", is, cx, cy, cz);
+        offset += np;
+        continue;
+      }
+      num_layer_cells++;
+      const bool ghost = cx==0 || cy==0 || cz==0
+        || cx==nxc-1 || cy==nyc-1 || cz==nzc-1;
+      if(np != (ghost ? 0 : npcel))
+        eprintf("cell (%d,%d,%d) of a layer has %d particles"
+          " of species %d", cx, cy, cz, np, is);
+      for(int pidx=offset;pidx<offset+np;pidx++)
+      {
+        const SpeciesParticle& pcl = new_list[pidx];
+        if(pcl.get_x() < grid.getXN(cx) || pcl.get_x() > grid.getXN(cx+1)
+        || pcl.get_y() < grid.getYN(cy) || pcl.get_y() > grid.getYN(cy+1)
+        || pcl.get_z() < grid.getZN(cz) || pcl.get_z() > grid.getZN(cz+1))
+          eprintf("particle %d of species %d is outside its cell"
+            " (%d,%d,%d)", pidx, is, cx, cy, cz);
+      }
+      offset += np;
+    }
+    if(offset != new_list.size())
+      eprintf("the buckets of species %d index %d of %d particles",
+        is, offset, int(new_list.size()));
+    if(!num_layer_cells)
+      eprintf("process %d has no layers to repopulate", MPIdata::get_rank());
+    pcls[is].assign(&new_list[0], &new_list[0]+new_list.size());
+  }
+  sim.delete_particles(part);
+}
+
+int main(int argc, char **argv)
+{
+  MPIdata::init(&argc, &argv);
+  if(argc < 2)
+    eprintf("usage: test_repopulate <input file>");
+  {
+    TestSimulation sim(argv[1]);
+    timeTasks.resetCycle();
+    timeTasks_set_main_task(TimeTasks::PARTICLES);
+    EMfields3D* EMf = sim.new_fields();
+    if(!MPIdata::get_rank())
+      printf("=== testing layers repopulated with 1 and 4 threads ===\n");
+    std::vector<Pcls> pcls1, pcls4;
+    repopulate(sim, EMf, 1, pcls1);
+    repopulate(sim, EMf, 4, pcls4);
+    for(int is=0;is<sim.ns;is++)
+    {
+      if(pcls1[is].size() != pcls4[is].size())
+        eprintf("species %d has %d particles with 1 thread but %d with 4",
+          is, int(pcls1[is].size()), int(pcls4[is].size()));
+      if(memcmp(&pcls1[is][0], &pcls4[is][0],
+          pcls1[is].size()*sizeof(SpeciesParticle)))
+        eprintf("the repopulated particles of species %d"
+          " depend on the number of threads", is);
+    }
+    delete EMf;
+  }
+  MPIdata::instance().finalize_mpi();
+  return 0;
+}
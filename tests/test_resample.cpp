@@ -0,0 +1,158 @@
+// test that resampling the particles of each cell
+// (Particles3D::resample_particles()) conserves the charge,
+// momentum, energy and center of charge of each cell and
+// brings the number of particles of each cell near npcel
+//
+// run on 1 process with inputs/test_resample.inp
+//
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include "MPIdata.h"
+#include "Collective.h"
+#include "Grid3DCU.h"
+#include "Particles3D.h"
+#include "errors.h"
+#include "TimeTasks.h"
+#include "TestParameters.h"
+#include "TestSimulation.h"
+
+// the quantities conserved in each cell
+// (momentum and energy are proportional to the
+// charge-weighted sums, since qom is fixed for a species)
+enum
+{
+  Q=0, // charge
+  QU, QV, QW, // momentum
+  QUU, // energy
+  QX, QY, QZ, // center of charge
+  NUM_SUMS
+};
+
+// sum the conserved quantities of the particles of each cell
+// and the same sums of their magnitudes (for the tolerance)
+static void sum_cells(const Particles3D& pcls, int num_cells[3],
+  std::vector<double>& sums, std::vector<double>& abs_sums)
+{
+  const int size = num_cells[0]*num_cells[1]*num_cells[2]*NUM_SUMS;
+  sums.assign(size, 0.);
+  abs_sums.assign(size, 0.);
+  for(int pidx=0;pidx<pcls.getNOP();pidx++)
+  {
+    const SpeciesParticle& pcl = pcls.get_pcl(pidx);
+    int cell[3];
+    pcls.get_pcl_cell(cell, pcl);
+    const int c = (cell[0]*num_cells[1] + cell[1])*num_cells[2] + cell[2];
+    const double q = pcl.get_q();
+    double terms[NUM_SUMS];
+    terms[Q] = q;
+    terms[QUU] = 0.;
+    for(int d=0;d<3;d++)
+    {
+      terms[QU+d] = q*pcl.get_u(d);
+      terms[QUU] += q*pcl.get_u(d)*pcl.get_u(d);
+      terms[QX+d] = q*pcl.get_x(d);
+    }
+    for(int i=0;i<NUM_SUMS;i++)
+    {
+      sums[c*NUM_SUMS+i] += terms[i];
+      abs_sums[c*NUM_SUMS+i] += fabs(terms[i]);
+    }
+  }
+}
+
+static int count_pcls_in_cell(const Particles3D& pcls, int cx, int cy, int cz)
+{
+  int count = 0;
+  for(int pidx=0;pidx<pcls.getNOP();pidx++)
+  {
+    int cell[3];
+    pcls.get_pcl_cell(cell, pcls.get_pcl(pidx));
+    if(cell[0]==cx && cell[1]==cy && cell[2]==cz)
+      count++;
+  }
+  return count;
+}
+
+static void test_resample(TestSimulation& sim)
+{
+  timeTasks_set_main_task(TimeTasks::PARTICLES);
+  const Grid3DCU& grid = *sim.grid;
+  int num_cells[3] = {grid.getNXC(), grid.getNYC(), grid.getNZC()};
+  Particles3D* part = sim.new_particles();
+  srand48(1);
+  for(int is=0;is<sim.ns;is++)
+  {
+    Particles3D& pcls = part[is];
+    const int npcel = sim.col->getNpcel(is);
+    const double q_sgn = sim.col->getQOM(is) > 0. ? 1. : -1.;
+
+    // fill the proper cells with too many particles,
+    // too few particles, or the right number
+    for(int cx=1;cx<num_cells[0]-1;cx++)
+    for(int cy=1;cy<num_cells[1]-1;cy++)
+    for(int cz=1;cz<num_cells[2]-1;cz++)
+    {
+      const int num_pcls_in_cell[3] = {5*npcel, 2, npcel};
+      const int np = num_pcls_in_cell[(cx+cy+cz)%3];
+      for(int i=0;i<np;i++)
+      {
+        const double x = grid.getXN(cx) + drand48()*grid.getDX();
+        const double y = grid.getYN(cy) + drand48()*grid.getDY();
+        const double z = grid.getZN(cz) + drand48()*grid.getDZ();
+        const double u = 0.1*(drand48()-0.5) + 0.02;
+        const double v = 0.1*(drand48()-0.5);
+        const double w = 0.1*(drand48()-0.5) - 0.01;
+        const double q = q_sgn*(0.5 + drand48())*1e-3;
+        pcls.add_new_particle(u,v,w,q,x,y,z,pcls.getNOP());
+      }
+    }
+
+    std::vector<double> sums_before, abs_sums;
+    sum_cells(pcls, num_cells, sums_before, abs_sums);
+    pcls.resample_particles();
+    std::vector<double> sums_after, abs_sums_after;
+    sum_cells(pcls, num_cells, sums_after, abs_sums_after);
+
+    // each cell keeps its charge, momentum, energy,
+    // and center of charge
+    const double tol = 1e-12;
+    for(int i=0;i<sums_before.size();i++)
+    {
+      if(fabs(sums_after[i]-sums_before[i]) > tol*abs_sums[i])
+        eprintf("species %d, cell %d: sum %d changed from %.17g to %.17g",
+          is, i/NUM_SUMS, i%NUM_SUMS, sums_before[i], sums_after[i]);
+    }
+    // and has about npcel particles: a full cell is merged
+    // velocity octant by velocity octant, each leaving at most
+    // two particles more than its share, and an empty cell is
+    // split up to npcel/2
+    for(int cx=1;cx<num_cells[0]-1;cx++)
+    for(int cy=1;cy<num_cells[1]-1;cy++)
+    for(int cz=1;cz<num_cells[2]-1;cz++)
+    {
+      const int np = count_pcls_in_cell(pcls, cx, cy, cz);
+      if(np > npcel + 2*8 || np < npcel/2)
+        eprintf("species %d, cell (%d,%d,%d) has %d particles",
+          is, cx, cy, cz, np);
+    }
+  }
+  sim.delete_particles(part);
+}
+
+int main(int argc, char **argv)
+{
+  MPIdata::init(&argc, &argv);
+  if(argc < 2)
+    eprintf("usage: test_resample <input file>");
+  {
+    TestSimulation sim(argv[1]);
+    timeTasks.resetCycle();
+    printf("=== testing merging and splitting particles ===\n");
+    test_resample(sim);
+  }
+  MPIdata::instance().finalize_mpi();
+  return 0;
+}
@@ -3,6 +3,7 @@
 #include <iostream>
 #include "BlockCommunicator.h"
 #include "IDgenerator.h"
+#include "../main/EditParameters.cpp"
 #include "../main/Parameters.cpp"
 #include "../utility/debug.cpp"
 #include "../utility/asserts.cpp"